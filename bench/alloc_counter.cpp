@@ -0,0 +1,44 @@
+#include "alloc_counter.hpp"
+
+#include <cstdlib>
+#include <new>
+
+// Replacement global allocation functions. The array forms forward to these by default,
+// over-aligned allocations are not counted.
+namespace{
+    thread_local std::uint64_t allocations = 0;
+
+    void *allocate(std::size_t size) noexcept {
+        allocations++;
+        return std::malloc(size == 0 ? 1 : size);
+    }
+}
+
+namespace bench{
+    std::uint64_t allocation_count() noexcept {
+        return allocations;
+    }
+}
+
+void *operator new(std::size_t size) {
+    if (auto ptr = allocate(size)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+    return allocate(size);
+}
+
+void operator delete(void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, const std::nothrow_t &) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
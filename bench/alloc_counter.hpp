@@ -0,0 +1,49 @@
+#ifndef ROS2_UART_AGENT_BENCH_ALLOC_COUNTER_HPP
+#define ROS2_UART_AGENT_BENCH_ALLOC_COUNTER_HPP
+#include <cstddef>
+#include <cstdint>
+#include "benchmark/benchmark.h"
+
+namespace bench{
+    /**
+     * Number of calls to the global operator new made by the calling thread so far.
+     * Counted by the replacement operators in alloc_counter.cpp.
+     */
+    std::uint64_t allocation_count() noexcept;
+
+    /**
+     * Counts the allocations made between construction and report().
+     * Usage: construct before the benchmark loop, call report(state) after it.
+     */
+    class AllocationScope{
+    public:
+        AllocationScope() noexcept : start_(allocation_count()) {}
+
+        /**
+         * Adds an "allocs/call" counter, averaged over the benchmark iterations
+         */
+        void report(benchmark::State &state) const {
+            auto allocations = static_cast<double>(allocation_count() - start_);
+            state.counters["allocs/call"] = benchmark::Counter(allocations, benchmark::Counter::kAvgIterations);
+        }
+
+    private:
+        std::uint64_t start_;
+    };
+
+    /**
+     * Reports bytes/s, frames/s and ns/frame for a benchmark that consumed the given amount of input
+     */
+    inline void report_throughput(benchmark::State &state, std::size_t bytes_per_iteration, std::size_t frames_per_iteration = 1){
+        auto iterations = static_cast<std::int64_t>(state.iterations());
+        if (bytes_per_iteration > 0) {
+            state.SetBytesProcessed(iterations * static_cast<std::int64_t>(bytes_per_iteration));
+        }
+        state.SetItemsProcessed(iterations * static_cast<std::int64_t>(frames_per_iteration));
+        // inverted rate, i.e. seconds per frame, printed with an SI prefix (n = ns)
+        state.counters["time/frame"] = benchmark::Counter(static_cast<double>(iterations * frames_per_iteration),
+                                                          benchmark::Counter::kIsRate | benchmark::Counter::kInvert);
+    }
+}
+
+#endif //ROS2_UART_AGENT_BENCH_ALLOC_COUNTER_HPP
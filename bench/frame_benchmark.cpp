@@ -0,0 +1,209 @@
+#include <array>
+#include <cstdint>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "benchmark/benchmark.h"
+#include "ros2_uart_agent/frame_helpers.hpp"
+#include "alloc_counter.hpp"
+
+namespace{
+    // ADC feedback as sent by the microcontroller, one field per joint
+    std::string make_feedback_payload(){
+        constexpr std::string_view fields[] = {"0890", "2011", "3020"};
+        std::string payload;
+        for (std::size_t i = 0; i < helpers::num_joints; i++) {
+            payload += fields[i % 3];
+            payload += i + 1 == helpers::num_joints ? '\n' : '\t';
+        }
+        return payload;
+    }
+
+    const std::string feedback_payload = make_feedback_payload();
+    // the command payload the agent sends for three joints
+    constexpr std::string_view command_payload = "-1.570796\t 0.000000\t 1.570796\n\x1a\x1a";
+
+    enum class Input{
+        Valid,
+        CrcMismatch,
+        Truncated,
+        MissingSoh,
+        Noise,
+    };
+
+    const char *to_string(Input input){
+        switch (input) {
+            case Input::Valid: return "valid";
+            case Input::CrcMismatch: return "crc_mismatch";
+            case Input::Truncated: return "truncated";
+            case Input::MissingSoh: return "missing_soh";
+            case Input::Noise: return "noise";
+        }
+        return "unknown";
+    }
+
+    std::string make_frame(std::string_view payload, std::uint32_t sec, std::uint32_t nsec){
+        std::array<char, 256> buffer{};
+        auto length = helpers::generate_message(buffer, payload, static_cast<std::int32_t>(sec), nsec);
+        // generate_message counts the null terminator
+        return std::string(buffer.data(), length - 1);
+    }
+
+    std::string make_input(Input input, std::uint32_t seed = 1){
+        auto frame = make_frame(feedback_payload, 1575000000 + seed, 123456789);
+        switch (input) {
+            case Input::Valid:
+                break;
+            case Input::CrcMismatch:
+                // flip a digit of the payload so the frame is well formed but fails the CRC check
+                frame[frame.find('\x02') + 2] ^= 0x01;
+                break;
+            case Input::Truncated:
+                frame.resize(frame.size() / 2);
+                break;
+            case Input::MissingSoh:
+                frame.erase(0, 1);
+                break;
+            case Input::Noise: {
+                std::mt19937 rng(seed);
+                std::uniform_int_distribution<int> byte(0, 255);
+                for (auto &c : frame) {
+                    c = static_cast<char>(byte(rng));
+                }
+                break;
+            }
+        }
+        return frame;
+    }
+
+    // stream of frames of which roughly bad_percent are damaged, the way the RX thread sees it
+    std::string make_stream(std::size_t frames, int bad_percent){
+        constexpr Input bad_inputs[] = {Input::CrcMismatch, Input::Truncated, Input::MissingSoh, Input::Noise};
+        std::mt19937 rng(42);
+        std::uniform_int_distribution<int> percent(0, 99);
+        std::string stream;
+        for (std::size_t i = 0; i < frames; i++) {
+            auto seed = static_cast<std::uint32_t>(i);
+            if (percent(rng) < bad_percent) {
+                stream += make_input(bad_inputs[i % 4], seed);
+            } else {
+                stream += make_input(Input::Valid, seed);
+            }
+        }
+        return stream;
+    }
+}
+
+static void BM_CRC32(benchmark::State &state){
+    std::vector<char> data(static_cast<std::size_t>(state.range(0)));
+    std::mt19937 rng(7);
+    for (auto &c : data) {
+        c = static_cast<char>(rng());
+    }
+    const char *first = data.data();
+    const char *last = first + data.size();
+    bench::AllocationScope allocations;
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(helpers::CRC32(first, last));
+    }
+    allocations.report(state);
+    bench::report_throughput(state, data.size());
+    state.SetLabel(helpers::to_string(helpers::crc32_engine()));
+}
+BENCHMARK(BM_CRC32)->Arg(16)->Arg(64)->Arg(256)->Arg(4096);
+
+static void BM_CRC32Engine(benchmark::State &state){
+    auto engine = static_cast<helpers::Crc32Engine>(state.range(0));
+    if (!helpers::crc32_engine_supported(engine)) {
+        state.SkipWithError("engine not supported on this CPU");
+        return;
+    }
+    std::vector<char> data(static_cast<std::size_t>(state.range(1)));
+    std::mt19937 rng(7);
+    for (auto &c : data) {
+        c = static_cast<char>(rng());
+    }
+    for (auto _ : state) {
+        benchmark::DoNotOptimize(helpers::crc32(engine, data.data(), data.size()));
+    }
+    bench::report_throughput(state, data.size());
+    state.SetLabel(helpers::to_string(engine));
+}
+BENCHMARK(BM_CRC32Engine)->ArgsProduct({
+    {static_cast<long>(helpers::Crc32Engine::SlicingBy8), static_cast<long>(helpers::Crc32Engine::Armv8),
+     static_cast<long>(helpers::Crc32Engine::Pclmul)},
+    {64, 4096}});
+
+static void BM_GenerateMessage(benchmark::State &state){
+    auto payload = state.range(0) == 0 ? std::string_view(feedback_payload) : command_payload;
+    std::array<char, 256> buffer{};
+    std::uint32_t nsec = 0;
+    std::size_t length = 0;
+    bench::AllocationScope allocations;
+    for (auto _ : state) {
+        length = helpers::generate_message(buffer, payload, 1575000000, nsec++);
+        benchmark::DoNotOptimize(buffer.data());
+    }
+    allocations.report(state);
+    bench::report_throughput(state, length);
+    state.SetLabel(state.range(0) == 0 ? "feedback" : "command");
+}
+BENCHMARK(BM_GenerateMessage)->Arg(0)->Arg(1);
+
+static void BM_ProcessInput(benchmark::State &state){
+    auto input = static_cast<Input>(state.range(0));
+    auto frame = make_input(input);
+    bench::AllocationScope allocations;
+    for (auto _ : state) {
+        auto result = helpers::process_input(frame);
+        benchmark::DoNotOptimize(result);
+    }
+    allocations.report(state);
+    bench::report_throughput(state, frame.size());
+    state.SetLabel(to_string(input));
+}
+BENCHMARK(BM_ProcessInput)->DenseRange(static_cast<int>(Input::Valid), static_cast<int>(Input::Noise));
+
+// the RX thread path: a long lived parser fed with read sized chunks of a mixed stream
+static void BM_FrameParserStream(benchmark::State &state){
+    constexpr std::size_t frames = 256;
+    auto chunk_size = static_cast<std::size_t>(state.range(1));
+    auto stream = make_stream(frames, static_cast<int>(state.range(0)));
+    helpers::FrameParser parser;
+    std::size_t valid = 0;
+    bench::AllocationScope allocations;
+    for (auto _ : state) {
+        for (std::size_t offset = 0; offset < stream.size(); offset += chunk_size) {
+            auto length = std::min(chunk_size, stream.size() - offset);
+            parser.feed(stream.data() + offset, length, [&valid](const helpers::FrameView &frame){
+                benchmark::DoNotOptimize(frame.payload.data());
+                valid++;
+            });
+        }
+    }
+    allocations.report(state);
+    bench::report_throughput(state, stream.size(), frames);
+    state.counters["valid/frame"] = benchmark::Counter(static_cast<double>(valid) / frames, benchmark::Counter::kAvgIterations);
+}
+BENCHMARK(BM_FrameParserStream)->ArgsProduct({{0, 10, 50}, {1, 32, 4096}})->ArgNames({"bad%", "chunk"});
+
+static void BM_GetJointStates(benchmark::State &state){
+    std::string payload(feedback_payload);
+    if (state.range(0) == 1) {
+        // a digit replaced by a letter, rejected by the decoder
+        payload[1] = 'x';
+    } else if (state.range(0) == 2) {
+        payload.resize(payload.size() - 3);
+    }
+    bench::AllocationScope allocations;
+    for (auto _ : state) {
+        auto joint_states = helpers::get_joint_states(payload);
+        benchmark::DoNotOptimize(joint_states);
+    }
+    allocations.report(state);
+    bench::report_throughput(state, payload.size());
+    const char *labels[] = {"valid", "bad_digit", "truncated"};
+    state.SetLabel(labels[state.range(0)]);
+}
+BENCHMARK(BM_GetJointStates)->DenseRange(0, 2);
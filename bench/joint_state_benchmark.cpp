@@ -0,0 +1,45 @@
+#include <array>
+#include <cstdint>
+#include <string>
+
+#include "benchmark/benchmark.h"
+#include "ros2_uart_agent/helpers.hpp"
+#include "alloc_counter.hpp"
+
+static void BM_CreateJointStateMsg(benchmark::State &state){
+    std::array<char, 128> payload{};
+    std::string feedback;
+    for (std::size_t i = 0; i < helpers::num_joints; i++) {
+        feedback += i + 1 == helpers::num_joints ? "2011\n" : "2011\t";
+    }
+    std::copy(feedback.cbegin(), feedback.cend(), payload.data());
+    helpers::JointVelocityEstimator velocity_estimator;
+    std::uint32_t nsec = 0;
+    bench::AllocationScope allocations;
+    for (auto _ : state) {
+        nsec += 1000000;
+        auto msg = helpers::create_joint_state_msg(payload, 1575000000, nsec % 1000000000, velocity_estimator);
+        benchmark::DoNotOptimize(msg.get());
+    }
+    allocations.report(state);
+    bench::report_throughput(state, feedback.size());
+}
+BENCHMARK(BM_CreateJointStateMsg);
+
+// the publish path when the node refills its member message instead of creating a new one
+static void BM_FillJointStateMsg(benchmark::State &state){
+    helpers::JointState msg;
+    std::array<double, helpers::num_joints> positions{};
+    std::array<double, helpers::num_joints> velocities{};
+    positions.fill(0.1);
+    velocities.fill(0.01);
+    std::uint32_t nsec = 0;
+    bench::AllocationScope allocations;
+    for (auto _ : state) {
+        helpers::fill_joint_state_msg(msg, positions, velocities, 1575000000, nsec++);
+        benchmark::DoNotOptimize(msg.position.data());
+    }
+    allocations.report(state);
+    bench::report_throughput(state, 0);
+}
+BENCHMARK(BM_FillJointStateMsg);
@@ -0,0 +1,74 @@
+#ifndef ROS2_UART_AGENT_ADC_DECODER_HPP
+#define ROS2_UART_AGENT_ADC_DECODER_HPP
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+#ifndef UART_AGENT_NUM_JOINTS
+#define UART_AGENT_NUM_JOINTS 3
+#endif
+
+namespace helpers{
+    /**
+     * Number of joints reported by the microcontroller, fixed at compile time (UART_AGENT_NUM_JOINTS in CMake)
+     */
+    constexpr std::size_t num_joints = UART_AGENT_NUM_JOINTS;
+    static_assert(num_joints > 0, "UART_AGENT_NUM_JOINTS must be positive");
+
+    /**
+     * Per joint calibration of the servo potentiometer
+     */
+    struct JointCalibration{
+        double adc_low = 890;    // adc reading at the lowest angle (-range/2)
+        double adc_high = 3020;  // adc reading at the highest angle (+range/2)
+        double range_deg = 180;  // mechanical range of the servo, 180 for the LDX218, 270 for the LDX227
+    };
+
+    /**
+     * Calibration that was hard coded before it became configurable: joint 1 is a 270 degree servo,
+     * the rest are 180 degree servos, all calibrated to ~890 at -range/2 and ~3020 at +range/2
+     */
+    template<std::size_t N>
+    std::array<JointCalibration, N> default_calibration();
+
+    /**
+     * Converts ADC readings to joint angles. The calibration is folded into one scale and offset per
+     * joint, so the conversion is a single multiply-add.
+     */
+    template<std::size_t N>
+    class AdcCalibration{
+    public:
+        explicit AdcCalibration(const std::array<JointCalibration, N> &calibration = default_calibration<N>());
+
+        /**
+         * @return joint angles in radians
+         */
+        std::array<double, N> apply(const std::array<std::uint16_t, N> &adc_values) const;
+
+    private:
+        std::array<double, N> scale_{};
+        std::array<double, N> offset_{};
+    };
+
+    /**
+     * Decodes the ASCII feedback payload "dddd\tdddd\t...dddd\n": N fixed width fields of 4 decimal
+     * digits (leading spaces allowed), each followed by TAB, the last one by a newline.
+     * Each field is validated and converted with 32-bit SWAR arithmetic in a single pass. Nothing has
+     * to be null terminated and nothing past 5 * N bytes is read.
+     * @return the ADC readings, or nullopt if the payload is too short or any field is malformed
+     */
+    template<std::size_t N>
+    std::optional<std::array<std::uint16_t, N>> decode_adc_fields(std::string_view payload);
+
+    /**
+     * Validates and converts one 4 character field loaded little endian, first character in the lowest byte
+     * @param valid cleared if the field is not 1-4 digits with optional leading spaces
+     */
+    std::uint16_t decode_adc_field(std::uint32_t field, bool &valid);
+}
+
+#include "adc_decoder.tpp"
+
+#endif //ROS2_UART_AGENT_ADC_DECODER_HPP
@@ -0,0 +1,49 @@
+namespace helpers{
+    template<std::size_t N>
+    std::array<JointCalibration, N> default_calibration(){
+        std::array<JointCalibration, N> calibration{};
+        calibration[0].range_deg = 270;
+        return calibration;
+    }
+
+    template<std::size_t N>
+    AdcCalibration<N>::AdcCalibration(const std::array<JointCalibration, N> &calibration){
+        // angle = (2 * adc - (high + low)) / (high - low) * range / 2
+        for (std::size_t i = 0; i < N; i++) {
+            const auto &joint = calibration[i];
+            auto half_range_rad = joint.range_deg * 3.14159265358979 / 360.0;
+            scale_[i] = 2.0 * half_range_rad / (joint.adc_high - joint.adc_low);
+            offset_[i] = -(joint.adc_high + joint.adc_low) * half_range_rad / (joint.adc_high - joint.adc_low);
+        }
+    }
+
+    template<std::size_t N>
+    std::array<double, N> AdcCalibration<N>::apply(const std::array<std::uint16_t, N> &adc_values) const{
+        std::array<double, N> angles;
+        for (std::size_t i = 0; i < N; i++) {
+            angles[i] = adc_values[i] * scale_[i] + offset_[i];
+        }
+        return angles;
+    }
+
+    template<std::size_t N>
+    std::optional<std::array<std::uint16_t, N>> decode_adc_fields(std::string_view payload){
+        if (payload.length() < 5 * N) {
+            return std::nullopt;
+        }
+        auto data = reinterpret_cast<const unsigned char *>(payload.data());
+        std::array<std::uint16_t, N> values;
+        bool valid = true;
+        for (std::size_t i = 0; i < N; i++) {
+            auto field = data + 5 * i;
+            auto word = static_cast<std::uint32_t>(field[0]) | (static_cast<std::uint32_t>(field[1]) << 8) |
+                        (static_cast<std::uint32_t>(field[2]) << 16) | (static_cast<std::uint32_t>(field[3]) << 24);
+            values[i] = decode_adc_field(word, valid);
+            valid &= field[4] == (i + 1 == N ? '\n' : '\t');
+        }
+        if (!valid) {
+            return std::nullopt;
+        }
+        return values;
+    }
+}
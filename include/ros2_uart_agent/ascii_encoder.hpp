@@ -0,0 +1,58 @@
+#ifndef ROS2_UART_AGENT_ASCII_ENCODER_HPP
+#define ROS2_UART_AGENT_ASCII_ENCODER_HPP
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+/*
+ * Allocation-free emitters for the ASCII framing. They produce exactly what the original
+ * sprintf based code produced ("%07u", "%09u", "% 08f", "%08X") without going through stdio,
+ * varargs or the locale, writing straight into a caller provided buffer.
+ */
+namespace helpers{
+    namespace ascii{
+        constexpr std::size_t max_goals = 16;
+        // sign, up to 13 integer digits, decimal point, 6 decimals and a separator
+        constexpr std::size_t max_goal_chars = 22;
+        constexpr std::size_t max_payload_size = max_goals * max_goal_chars + 3; // plus SUB padding
+        // SOH, 10 digit sec, TAB, 10 digit nsec, STX, payload, ETX, 8 hex CRC, EOT, null terminator
+        constexpr std::size_t max_frame_size = 1 + 10 + 1 + 10 + 1 + max_payload_size + 1 + 8 + 1 + 1;
+    }
+
+    /**
+     * Writes value as decimal, zero padded to at least min_width digits ("%0<min_width>u")
+     * @return pointer past the last character written
+     */
+    char *write_decimal(char *out, std::uint32_t value, int min_width);
+
+    /**
+     * Writes value as 8 upper case hex digits ("%08X")
+     * @return pointer past the last character written
+     */
+    char *write_hex32(char *out, std::uint32_t value);
+
+    /**
+     * Writes a joint goal the way "% 08f" does: a space or minus sign followed by 6 decimals
+     * @return pointer past the last character written, nullptr if the value is not finite or too large
+     */
+    char *write_goal(char *out, double value);
+
+    /**
+     * Builds a complete command frame, SOH header STX goals ETX CRC EOT, in one pass.
+     * Goals are separated by TAB and terminated by a newline, the payload is padded with SUB to a
+     * multiple of 4 bytes as the microcontroller expects.
+     * @param buffer destination, at least ascii::max_frame_size bytes
+     * @return frame length excluding the null terminator, 0 if a goal could not be encoded
+     */
+    std::size_t encode_ascii_command(char *buffer, const double *goals, std::size_t count,
+                                     std::uint32_t sec, std::uint32_t nsec);
+
+    /**
+     * Frames an already formatted payload, used by generate_message
+     * @param buffer destination, at least payload.length() + 40 bytes
+     * @return frame length excluding the null terminator
+     */
+    std::size_t frame_ascii_payload(char *buffer, std::string_view payload, std::uint32_t sec, std::uint32_t nsec);
+}
+
+#endif //ROS2_UART_AGENT_ASCII_ENCODER_HPP
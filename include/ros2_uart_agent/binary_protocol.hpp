@@ -0,0 +1,143 @@
+#ifndef ROS2_UART_AGENT_BINARY_PROTOCOL_HPP
+#define ROS2_UART_AGENT_BINARY_PROTOCOL_HPP
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <utility>
+#include "ros2_uart_agent/frame_parser.hpp"
+
+/*
+ * Compact binary framing, used instead of the ASCII SOH/STX/ETX/EOT framing when the
+ * "protocol" parameter is set to "binary". A frame before byte stuffing is laid out as
+ *
+ *   [type:u8][sec:u32][nsec:u32][count:u8][body][crc:u32]
+ *
+ * with all integers little endian. The body holds count float32 joint goals for a command
+ * frame, or count u16 ADC readings for a feedback frame. The CRC32 covers everything before
+ * it. The frame is then COBS encoded and terminated by a single 0x00 delimiter, so a decoder
+ * can resynchronise on the next zero byte after corruption.
+ */
+namespace helpers{
+    enum class Protocol : std::uint8_t{
+        Ascii,
+        Binary
+    };
+
+    /**
+     * Parses the value of the "protocol" parameter
+     * @return the protocol, or nullopt if the name is not recognised
+     */
+    std::optional<Protocol> protocol_from_string(std::string_view name);
+
+    /**
+     * @return the parameter value naming the protocol
+     */
+    const char *to_string(Protocol protocol);
+
+    enum class BinaryMessageType : std::uint8_t{
+        JointCommand = 0x01,
+        AdcFeedback = 0x02
+    };
+
+    namespace binary{
+        constexpr std::size_t header_size = 10;
+        constexpr std::size_t crc_size = 4;
+        constexpr std::size_t max_values = 16;
+        constexpr std::size_t max_frame_size = header_size + max_values * 4 + crc_size;
+        // COBS adds at most one byte per 254, plus the leading code byte and the delimiter
+        constexpr std::size_t max_encoded_size = max_frame_size + max_frame_size / 254 + 2;
+    }
+
+    /**
+     * A validated binary frame. body points into the decoder and is only valid during the callback.
+     */
+    struct BinaryFrameView{
+        BinaryMessageType type = BinaryMessageType::JointCommand;
+        std::uint32_t sec = 0;
+        std::uint32_t nsec = 0;
+        std::uint8_t count = 0;
+        const unsigned char *body = nullptr;
+        std::size_t body_length = 0;
+
+        float goal(std::size_t index) const;
+
+        std::uint16_t adc_value(std::size_t index) const;
+    };
+
+    /**
+     * Encodes a joint command frame
+     * @param buffer destination, at least binary::max_encoded_size bytes
+     * @param goals joint goals, at most binary::max_values, converted to float32
+     * @return number of bytes written including the 0x00 delimiter, 0 if too many goals
+     */
+    std::size_t encode_binary_command(char *buffer, const double *goals, std::size_t count,
+                                      std::uint32_t sec, std::uint32_t nsec);
+
+    /**
+     * Encodes an ADC feedback frame, the counterpart sent by the microcontroller
+     * @return number of bytes written including the 0x00 delimiter, 0 if too many values
+     */
+    std::size_t encode_binary_feedback(char *buffer, const std::uint16_t *adc_values, std::size_t count,
+                                       std::uint32_t sec, std::uint32_t nsec);
+
+    /**
+     * COBS encodes data into buffer and appends the 0x00 delimiter
+     * @return number of bytes written
+     */
+    std::size_t cobs_encode(const unsigned char *data, std::size_t length, char *buffer);
+
+    /**
+     * Incremental COBS decoder for the binary framing. Bytes are unstuffed as they arrive,
+     * so a frame never has to be buffered twice.
+     */
+    class BinaryFrameDecoder{
+    public:
+        /**
+         * Feeds a chunk of received bytes into the decoder
+         * @param on_frame called with a BinaryFrameView for every valid frame
+         * @param on_error called with a FrameError for every rejected frame
+         * @return number of valid frames found in this chunk
+         */
+        template<typename OnFrame, typename OnError>
+        std::size_t feed(const char *data, std::size_t length, OnFrame &&on_frame, OnError &&on_error);
+
+        template<typename OnFrame>
+        std::size_t feed(const char *data, std::size_t length, OnFrame &&on_frame){
+            return feed(data, length, std::forward<OnFrame>(on_frame), [](FrameError){});
+        }
+
+        void reset();
+
+        std::uint64_t valid_count() const { return valid_count_; }
+
+        std::uint64_t error_count(FrameError error) const { return error_counts_[static_cast<std::size_t>(error)]; }
+
+        std::uint64_t total_error_count() const;
+
+        /**
+         * Records the duration of every CRC check into histogram, nullptr to stop.
+         * Does nothing when metrics are compiled out.
+         */
+        void set_crc_histogram(LatencyHistogram *histogram) { crc_histogram_ = histogram; }
+
+    private:
+        FrameError validate(BinaryFrameView &view) const;
+
+        std::array<unsigned char, binary::max_frame_size> frame_{};
+        std::size_t length_ = 0;
+        // bytes left in the current COBS block, 0 means the next byte is a code byte
+        std::uint8_t block_left_ = 0;
+        bool zero_pending_ = false;
+        bool started_ = false;
+        bool overflowed_ = false;
+        std::uint64_t valid_count_ = 0;
+        std::array<std::uint64_t, static_cast<std::size_t>(FrameError::Count)> error_counts_{};
+        LatencyHistogram *crc_histogram_ = nullptr;
+    };
+}
+
+#include "binary_protocol.tpp"
+
+#endif //ROS2_UART_AGENT_BINARY_PROTOCOL_HPP
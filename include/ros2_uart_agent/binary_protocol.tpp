@@ -0,0 +1,53 @@
+namespace helpers{
+    template<typename OnFrame, typename OnError>
+    std::size_t BinaryFrameDecoder::feed(const char *data, std::size_t length, OnFrame &&on_frame, OnError &&on_error){
+        std::size_t frames = 0;
+        for (std::size_t i = 0; i < length; i++) {
+            const auto byte = static_cast<unsigned char>(data[i]);
+            if (byte == 0) {
+                if (!started_) {
+                    continue; // repeated delimiters are allowed as idle fill
+                }
+                FrameError error = FrameError::None;
+                BinaryFrameView view{};
+                if (overflowed_) {
+                    error = FrameError::Oversize;
+                } else if (block_left_ != 0) {
+                    error = FrameError::UnexpectedControl; // delimiter inside a COBS block, frame was truncated
+                } else {
+                    error = validate(view);
+                }
+                if (error == FrameError::None) {
+                    valid_count_++;
+                    frames++;
+                    on_frame(static_cast<const BinaryFrameView &>(view));
+                } else {
+                    error_counts_[static_cast<std::size_t>(error)]++;
+                    on_error(error);
+                }
+                reset();
+                continue;
+            }
+            started_ = true;
+            if (block_left_ == 0) {
+                if (zero_pending_) {
+                    if (length_ < frame_.size()) {
+                        frame_[length_++] = 0;
+                    } else {
+                        overflowed_ = true;
+                    }
+                }
+                block_left_ = byte - 1;
+                zero_pending_ = byte != 0xFF;
+                continue;
+            }
+            if (length_ < frame_.size()) {
+                frame_[length_++] = byte;
+            } else {
+                overflowed_ = true;
+            }
+            block_left_--;
+        }
+        return frames;
+    }
+}
@@ -0,0 +1,70 @@
+#ifndef ROS2_UART_AGENT_CRC32_HPP
+#define ROS2_UART_AGENT_CRC32_HPP
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace helpers{
+    namespace detail{
+        constexpr std::uint32_t crc32_polynomial = 0xEDB88320u;
+
+        /**
+         * Generates the slicing-by-8 tables at compile time. Table 0 is the classic byte-wise table,
+         * table k gives the CRC of a byte followed by k zero bytes.
+         */
+        constexpr std::array<std::array<std::uint32_t, 256>, 8> make_crc32_tables(){
+            std::array<std::array<std::uint32_t, 256>, 8> tables{};
+            for (std::uint32_t n = 0; n < 256; n++) {
+                auto checksum = n;
+                for (int i = 0; i < 8; i++) {
+                    checksum = (checksum >> 1) ^ ((checksum & 0x1u) ? crc32_polynomial : 0);
+                }
+                tables[0][n] = checksum;
+            }
+            for (std::size_t k = 1; k < tables.size(); k++) {
+                for (std::size_t n = 0; n < 256; n++) {
+                    auto previous = tables[k - 1][n];
+                    tables[k][n] = (previous >> 8) ^ tables[0][previous & 0xFFu];
+                }
+            }
+            return tables;
+        }
+
+        inline constexpr auto crc32_tables = make_crc32_tables();
+    }
+
+    /**
+     * CRC32 implementations, the fastest one supported by the CPU is picked once at runtime
+     */
+    enum class Crc32Engine : std::uint8_t{
+        SlicingBy8, // portable table driven implementation, 8 bytes per step
+        Armv8,      // ARMv8 CRC32 instructions (__crc32b/w/d)
+        Pclmul      // x86 carry-less multiply folding, 64 bytes per step
+    };
+
+    const char *to_string(Crc32Engine engine);
+
+    /**
+     * @return whether the engine can run on this CPU, SlicingBy8 is always supported
+     */
+    bool crc32_engine_supported(Crc32Engine engine);
+
+    /**
+     * @return the engine used by crc32()
+     */
+    Crc32Engine crc32_engine();
+
+    /**
+     * Calculates the CRC32 (reflected polynomial 0xEDB88320) of a buffer using the selected engine.
+     * Follows the zlib convention so a CRC can be extended: crc32(b, nb, crc32(a, na)) == crc32(ab, na + nb)
+     * @param crc CRC of the preceding data, 0 to start a new CRC
+     */
+    std::uint32_t crc32(const void *data, std::size_t length, std::uint32_t crc = 0);
+
+    /**
+     * Same as crc32() but with an explicit engine, falls back to SlicingBy8 if the engine is not supported
+     */
+    std::uint32_t crc32(Crc32Engine engine, const void *data, std::size_t length, std::uint32_t crc = 0);
+}
+
+#endif //ROS2_UART_AGENT_CRC32_HPP
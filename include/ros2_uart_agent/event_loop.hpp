@@ -0,0 +1,60 @@
+#ifndef ROS2_UART_AGENT_EVENT_LOOP_HPP
+#define ROS2_UART_AGENT_EVENT_LOOP_HPP
+#include <cstddef>
+#include <cstdint>
+
+namespace helpers{
+    /**
+     * Waits on several descriptors from one thread with a single epoll instance. Descriptors are
+     * level triggered and identified by a caller chosen id, so one thread can serve any number of
+     * serial links without a thread per port.
+     */
+    class EventLoop{
+    public:
+        EventLoop();
+        ~EventLoop();
+        EventLoop(const EventLoop &) = delete;
+        EventLoop &operator=(const EventLoop &) = delete;
+
+        bool is_open() const { return epoll_fd_ >= 0 && wake_fd_ >= 0; }
+
+        /**
+         * Watches fd for input
+         * @param id passed to the callback of run() when fd is readable
+         * @return false if the descriptor could not be added, errors are printed to stderr
+         */
+        bool add(int fd, std::size_t id);
+
+        void remove(int fd);
+
+        /**
+         * Dispatches readiness until stop() is called
+         * @param on_event called as on_event(id, hung_up) for every ready descriptor. hung_up is true when
+         *                 the device reported an error or hangup, the callback should then drain what is
+         *                 left and remove() it, level triggered readiness would otherwise repeat forever.
+         */
+        template<typename OnEvent>
+        void run(OnEvent &&on_event);
+
+        /**
+         * Makes run() return, can be called from any thread and before run() was entered
+         */
+        void stop();
+
+    private:
+        static constexpr std::uint64_t wake_id = UINT64_MAX;
+        static constexpr int max_events = 16;
+
+        /**
+         * @return number of events written to ids/hung_up, -1 when stopped or on error
+         */
+        int wait(std::uint64_t *ids, bool *hung_up);
+
+        int epoll_fd_ = -1;
+        int wake_fd_ = -1;
+    };
+}
+
+#include "event_loop.tpp"
+
+#endif //ROS2_UART_AGENT_EVENT_LOOP_HPP
@@ -0,0 +1,16 @@
+namespace helpers{
+    template<typename OnEvent>
+    void EventLoop::run(OnEvent &&on_event){
+        std::uint64_t ids[max_events];
+        bool hung_up[max_events];
+        while (true) {
+            auto ready = wait(ids, hung_up);
+            if (ready < 0) {
+                return;
+            }
+            for (int i = 0; i < ready; i++) {
+                on_event(static_cast<std::size_t>(ids[i]), hung_up[i]);
+            }
+        }
+    }
+}
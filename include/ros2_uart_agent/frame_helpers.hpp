@@ -0,0 +1,91 @@
+#ifndef ROS2_UART_AGENT_FRAME_HELPERS_HPP
+#define ROS2_UART_AGENT_FRAME_HELPERS_HPP
+#include <algorithm>
+#include <array>
+#include <tuple>
+#include <string>
+#include <string_view>
+#include <vector>
+#include <cstdint>
+#include <iostream>
+#include <optional>
+#include <type_traits>
+#include "ros2_uart_agent/adc_decoder.hpp"
+#include "ros2_uart_agent/ascii_encoder.hpp"
+#include "ros2_uart_agent/crc32.hpp"
+#include "ros2_uart_agent/frame_parser.hpp"
+
+// Framing and decoding helpers that do not depend on ROS message types
+
+namespace std_extensions{
+   template<class T>
+   struct is_array : std::is_array<T> {};
+   template<class T, std::size_t N>
+   struct is_array<std::array<T, N>> : std::true_type {};
+   template<>
+   struct is_array<std::string> : std::true_type {};
+   template<class T>
+   struct is_array<std::vector<T>> : std::true_type {};
+}
+
+
+namespace helpers{
+    // Generates a lookup table for the checksums of all 8-bit values.
+    std::array<std::uint_fast32_t, 256> generate_crc_lookup_table() noexcept;
+
+// Calculates the CRC for any sequence of 8-bit values. Contiguous char buffers go through the
+// runtime dispatched engine in crc32.hpp, other iterators use the byte-wise table.
+    template<typename InputIterator>
+    std::uint_fast32_t CRC32(InputIterator first, InputIterator last) {
+        using value_type = std::remove_cv_t<std::remove_reference_t<decltype(*first)>>;
+        if constexpr (std::is_pointer_v<InputIterator> && sizeof(value_type) == 1) {
+            return crc32(first, last - first);
+        } else {
+            const auto &table = detail::crc32_tables[0];
+            std::uint32_t checksum = 0xFFFFFFFFu;
+            for (; first != last; ++first) {
+                checksum = table[(checksum ^ static_cast<std::uint8_t>(*first)) & 0xFFu] ^ (checksum >> 8);
+            }
+            return ~checksum;
+        }
+    }
+
+    /**
+     * Checks whether the input contains a valid frame and returns the payload of the first one.
+     * Parsing is done in a single pass by FrameParser.
+     * @tparam T contiguous char container, e.g. std::array<char, N> or std::string_view
+     * @param array
+     * @return optional payload char array, null terminated
+     */
+    template<typename T>
+    std::optional<std::tuple<std::array<char, 128>, uint32_t, uint32_t>> process_input(const T& array);
+
+    int get_count(const std::vector<char> &array);
+
+
+    /**
+     * Generates a standard message with CRC32 and control characters in the proper places.
+     * Currently this message is expected to have time component in header
+     * @tparam T std::array<char, N> is expected
+     * @param data_array buffer to store the data of the generated message
+     * @param payload_sv payload of the message
+     * @param sec seconds portion of current time
+     * @param nsec nanoseconds portion of current time
+     * @return length of the message including the null terminator, 0 if the buffer is too small
+     */
+    template<typename T>
+    unsigned long
+    generate_message(T &data_array, const std::string_view &payload_sv, const int32_t sec, const uint32_t nsec);
+
+    /**
+     * Decodes an ASCII feedback payload of num_joints fields with decode_adc_fields and the default calibration
+     * @tparam T contiguous char container, e.g. std::array<char, N> or std::string_view
+     * @return joint angles in radians, or nullopt if the payload is malformed
+     */
+    template<typename T>
+    std::optional<std::array<double, num_joints>> get_joint_states(const T &array);
+}
+
+#include "frame_helpers.tpp"
+
+#endif //ROS2_UART_AGENT_FRAME_HELPERS_HPP
@@ -0,0 +1,40 @@
+namespace helpers{
+    template<typename T>
+    std::optional<std::tuple<std::array<char, 128>, uint32_t, uint32_t>> process_input(const T& array) {
+        std::optional<std::tuple<std::array<char, 128>, uint32_t, uint32_t>> result;
+        FrameParser parser(array.size());
+        parser.feed(array.data(), array.size(), [&result](const FrameView &frame){
+            // only the first valid frame is returned, payload has to leave room for the null terminator
+            if (result || frame.payload.length() >= 128) {
+                return;
+            }
+            std::array<char, 128> main_content_array{};
+            std::copy(frame.payload.cbegin(), frame.payload.cend(), main_content_array.data());
+            result = std::make_tuple(main_content_array, frame.sec, frame.nsec);
+        });
+        return result;
+    }
+
+   template<typename T>
+    unsigned long
+    generate_message(T &data_array, const std::string_view &payload_sv, const int32_t sec, const uint32_t nsec){
+        static_assert(std_extensions::is_array<T>::value, "T must be an array type");
+        // header, padding, control characters, CRC and null terminator need at most 40 extra bytes
+        if (data_array.size() < payload_sv.length() + 40) {
+            std::cerr << "generate_message buffer too small for payload of " << payload_sv.length() << " bytes" << std::endl;
+            return 0;
+        }
+        // add null terminator such that C-style operations can be performed successfully on this data array
+        return frame_ascii_payload(&data_array[0], payload_sv, sec, nsec) + 1;
+    }
+
+    template<typename T>
+    std::optional<std::array<double, num_joints>> get_joint_states(const T &array){
+        static const AdcCalibration<num_joints> calibration;
+        auto adc_values = decode_adc_fields<num_joints>(std::string_view(array.data(), array.size()));
+        if (!adc_values) {
+            return std::nullopt;
+        }
+        return calibration.apply(*adc_values);
+    }
+}
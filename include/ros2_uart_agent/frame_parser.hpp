@@ -0,0 +1,106 @@
+#ifndef ROS2_UART_AGENT_FRAME_PARSER_HPP
+#define ROS2_UART_AGENT_FRAME_PARSER_HPP
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+#include <utility>
+#include <vector>
+#include "ros2_uart_agent/metrics.hpp"
+
+namespace helpers{
+    /**
+     * Reason a frame was rejected by the FrameParser
+     */
+    enum class FrameError : std::uint8_t{
+        None = 0,
+        UnexpectedControl, // control character out of SOH, STX, ETX, EOT order, parser resynchronises on the next SOH
+        Oversize,          // frame longer than the configured maximum
+        BadHeader,         // header is not "<sec>\t<nsec>"
+        BadCrcField,       // CRC field is not 8 hex characters
+        CrcMismatch,       // CRC field does not match the payload
+        Count
+    };
+
+    const char *to_string(FrameError error);
+
+    /**
+     * A validated frame. All views point either into the chunk that was fed to the parser or,
+     * if the frame spanned several chunks, into the parser's carry buffer. They are only valid
+     * for the duration of the callback.
+     */
+    struct FrameView{
+        std::string_view header;  // between SOH and STX
+        std::string_view payload; // between STX and ETX, including SUB padding
+        std::string_view crc;     // between ETX and EOT
+        std::uint32_t sec = 0;
+        std::uint32_t nsec = 0;
+    };
+
+    /**
+     * Incremental SOH/STX/ETX/EOT frame parser. State is kept across chunks so it can be fed
+     * straight from read(). Frames that lie entirely within one chunk are handed out without copying.
+     */
+    class FrameParser{
+    public:
+        explicit FrameParser(std::size_t max_frame_size = 256) : max_frame_size_(max_frame_size) {}
+
+        /**
+         * Feeds a chunk of received bytes into the parser
+         * @param on_frame called with a FrameView for every valid frame
+         * @param on_error called with a FrameError for every rejected frame
+         * @return number of valid frames found in this chunk
+         */
+        template<typename OnFrame, typename OnError>
+        std::size_t feed(const char *data, std::size_t length, OnFrame &&on_frame, OnError &&on_error);
+
+        template<typename OnFrame>
+        std::size_t feed(const char *data, std::size_t length, OnFrame &&on_frame){
+            return feed(data, length, std::forward<OnFrame>(on_frame), [](FrameError){});
+        }
+
+        /**
+         * Drops any partially received frame
+         */
+        void reset();
+
+        std::uint64_t valid_count() const { return valid_count_; }
+
+        std::uint64_t error_count(FrameError error) const { return error_counts_[static_cast<std::size_t>(error)]; }
+
+        std::uint64_t total_error_count() const;
+
+        /**
+         * Records the duration of every CRC check into histogram, nullptr to stop.
+         * Does nothing when metrics are compiled out.
+         */
+        void set_crc_histogram(LatencyHistogram *histogram) { crc_histogram_ = histogram; }
+
+    private:
+        enum class State : std::uint8_t { SeekSoh, Header, Payload, Crc };
+
+        /**
+         * Validates the header and CRC of a complete frame
+         * @param frame the frame from SOH to EOT inclusive
+         */
+        FrameError validate(std::string_view frame, FrameView &view) const;
+
+        void start_frame(std::size_t offset);
+
+        std::size_t max_frame_size_;
+        State state_ = State::SeekSoh;
+        // offsets relative to the start of the current frame
+        std::size_t frame_length_ = 0;
+        std::size_t stx_offset_ = 0;
+        std::size_t etx_offset_ = 0;
+        // holds the head of a frame that spans chunks, reserved on first use
+        std::vector<char> carry_;
+        std::uint64_t valid_count_ = 0;
+        std::array<std::uint64_t, static_cast<std::size_t>(FrameError::Count)> error_counts_{};
+        LatencyHistogram *crc_histogram_ = nullptr;
+    };
+}
+
+#include "frame_parser.tpp"
+
+#endif //ROS2_UART_AGENT_FRAME_PARSER_HPP
@@ -0,0 +1,110 @@
+#include <cstring>
+
+namespace helpers{
+    template<typename OnFrame, typename OnError>
+    std::size_t FrameParser::feed(const char *data, std::size_t length, OnFrame &&on_frame, OnError &&on_error){
+        std::size_t frames = 0;
+        // true when the head of the current frame arrived in an earlier chunk and lives in carry_
+        bool carried = state_ != State::SeekSoh;
+        std::size_t frame_start = 0;
+
+        auto reject = [&](FrameError error){
+            error_counts_[static_cast<std::size_t>(error)]++;
+            on_error(error);
+            state_ = State::SeekSoh;
+            carried = false;
+            carry_.clear();
+        };
+
+        std::size_t i = 0;
+        while (i < length) {
+            if (state_ == State::SeekSoh) {
+                auto soh = static_cast<const char *>(std::memchr(data + i, '\x01', length - i));
+                if (soh == nullptr) {
+                    break;
+                }
+                i = soh - data;
+                frame_start = i;
+                start_frame(1);
+                carried = false;
+                i++;
+                continue;
+            }
+
+            const auto c = static_cast<unsigned char>(data[i]);
+            frame_length_++;
+            if (frame_length_ > max_frame_size_) {
+                reject(FrameError::Oversize);
+                // a SOH here starts the next frame, re-examine it in the SeekSoh state
+                if (c != 0x01) {
+                    i++;
+                }
+                continue;
+            }
+            if (c - 1u >= 4u) {
+                i++;
+                continue;
+            }
+            switch (c) {
+                case 0x01:
+                    // SOH inside a frame: the previous frame was truncated, restart at this byte
+                    reject(FrameError::UnexpectedControl);
+                    continue;
+                case 0x02:
+                    if (state_ == State::Header) {
+                        stx_offset_ = frame_length_ - 1;
+                        state_ = State::Payload;
+                    } else {
+                        reject(FrameError::UnexpectedControl);
+                    }
+                    break;
+                case 0x03:
+                    if (state_ == State::Payload) {
+                        etx_offset_ = frame_length_ - 1;
+                        state_ = State::Crc;
+                    } else {
+                        reject(FrameError::UnexpectedControl);
+                    }
+                    break;
+                default:
+                    if (state_ != State::Crc) {
+                        reject(FrameError::UnexpectedControl);
+                        break;
+                    }
+                    std::string_view frame;
+                    if (carried) {
+                        carry_.insert(carry_.end(), data, data + i + 1);
+                        frame = std::string_view(carry_.data(), carry_.size());
+                    } else {
+                        frame = std::string_view(data + frame_start, i + 1 - frame_start);
+                    }
+                    FrameView view{};
+                    auto error = validate(frame, view);
+                    if (error == FrameError::None) {
+                        valid_count_++;
+                        frames++;
+                        on_frame(static_cast<const FrameView &>(view));
+                        state_ = State::SeekSoh;
+                        carried = false;
+                        carry_.clear();
+                    } else {
+                        reject(error);
+                    }
+                    break;
+            }
+            i++;
+        }
+
+        if (state_ != State::SeekSoh) {
+            if (carry_.capacity() < max_frame_size_) {
+                carry_.reserve(max_frame_size_);
+            }
+            if (carried) {
+                carry_.insert(carry_.end(), data, data + length);
+            } else {
+                carry_.assign(data + frame_start, data + length);
+            }
+        }
+        return frames;
+    }
+}
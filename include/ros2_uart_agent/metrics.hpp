@@ -0,0 +1,143 @@
+#ifndef ROS2_UART_AGENT_METRICS_HPP
+#define ROS2_UART_AGENT_METRICS_HPP
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <time.h>
+
+// Set to 0 through the UART_AGENT_ENABLE_METRICS CMake option to compile the instrumentation out
+#ifndef UART_AGENT_ENABLE_METRICS
+#define UART_AGENT_ENABLE_METRICS 1
+#endif
+
+/*
+ * Lock-free latency histograms and counters for the RX and TX hot paths. Recording is a handful
+ * of relaxed atomic increments, so it is safe from any thread and never blocks the writer. With
+ * metrics disabled every operation is an empty inline function and the clock is never read.
+ */
+namespace helpers{
+    constexpr bool metrics_enabled = UART_AGENT_ENABLE_METRICS != 0;
+
+    /**
+     * @return CLOCK_MONOTONIC in nanoseconds, 0 if metrics are disabled
+     */
+    inline std::int64_t metrics_clock_ns() noexcept {
+        if constexpr (metrics_enabled) {
+            timespec now{};
+            clock_gettime(CLOCK_MONOTONIC, &now);
+            return static_cast<std::int64_t>(now.tv_sec) * 1000000000 + now.tv_nsec;
+        } else {
+            return 0;
+        }
+    }
+
+    class MetricCounter{
+    public:
+        void add(std::uint64_t n = 1) noexcept {
+            if constexpr (metrics_enabled) {
+                value_.fetch_add(n, std::memory_order_relaxed);
+            }
+        }
+
+        std::uint64_t value() const noexcept { return value_.load(std::memory_order_relaxed); }
+
+    private:
+        std::atomic<std::uint64_t> value_{0};
+    };
+
+    /**
+     * HDR style log-linear histogram of nanosecond values. Every power of two is split into 16
+     * linear sub-buckets, so a recorded value is known to within 1/16 (~6%) over the whole range
+     * from 1 ns to 2^40 ns (~18 minutes). Larger values land in the last bucket.
+     */
+    class LatencyHistogram{
+    public:
+        static constexpr unsigned sub_bucket_bits = 4;
+        static constexpr std::size_t sub_bucket_count = std::size_t{1} << sub_bucket_bits;
+        static constexpr unsigned max_exponent = 40;
+        static constexpr std::size_t bucket_count = (max_exponent - sub_bucket_bits + 1) * sub_bucket_count;
+
+        /**
+         * Counts of a histogram at one point in time. Subtracting an earlier snapshot of the same
+         * histogram gives the distribution of the values recorded in between.
+         */
+        struct Snapshot{
+            std::array<std::uint64_t, bucket_count> counts{};
+            std::uint64_t count = 0;
+            std::uint64_t sum = 0;
+
+            /**
+             * @return the values recorded after earlier was taken
+             */
+            Snapshot since(const Snapshot &earlier) const;
+
+            /**
+             * @param percentile 0 to 100
+             * @return representative value of the bucket holding the percentile, 0 if empty
+             */
+            std::uint64_t percentile(double percentile) const;
+
+            /**
+             * @return upper bound of the highest non-empty bucket, 0 if empty
+             */
+            std::uint64_t max() const;
+
+            double mean() const { return count == 0 ? 0 : static_cast<double>(sum) / static_cast<double>(count); }
+        };
+
+        void record(std::int64_t value) noexcept {
+            if constexpr (metrics_enabled) {
+                auto magnitude = static_cast<std::uint64_t>(value < 0 ? 0 : value);
+                counts_[bucket_index(magnitude)].fetch_add(1, std::memory_order_relaxed);
+                sum_.fetch_add(magnitude, std::memory_order_relaxed);
+            }
+        }
+
+        Snapshot snapshot() const;
+
+        static std::size_t bucket_index(std::uint64_t value) noexcept {
+            if (value < sub_bucket_count) {
+                return static_cast<std::size_t>(value);
+            }
+            auto exponent = static_cast<unsigned>(63 - __builtin_clzll(value));
+            if (exponent >= max_exponent) {
+                return bucket_count - 1;
+            }
+            auto sub_bucket = (value >> (exponent - sub_bucket_bits)) - sub_bucket_count;
+            return (exponent - sub_bucket_bits + 1) * sub_bucket_count + static_cast<std::size_t>(sub_bucket);
+        }
+
+        static std::uint64_t bucket_lower_bound(std::size_t index) noexcept;
+
+        static std::uint64_t bucket_upper_bound(std::size_t index) noexcept;
+
+    private:
+        std::array<std::atomic<std::uint64_t>, metrics_enabled ? bucket_count : 1> counts_{};
+        std::atomic<std::uint64_t> sum_{0};
+    };
+
+    /**
+     * Metrics of one serial link. Stage latencies are taken on the monotonic clock, byte arrival is
+     * the moment read() returned the chunk that completed the frame.
+     */
+    struct LinkMetrics{
+        MetricCounter rx_bytes;
+        MetricCounter rx_frames;          // frames that passed framing and CRC
+        MetricCounter crc_failures;
+        MetricCounter framing_errors;     // any other rejected frame
+        MetricCounter decode_errors;      // valid frames with an unusable payload
+        MetricCounter published;
+        MetricCounter tx_frames;
+        LatencyHistogram frame_latency;   // byte arrival -> frame complete, includes the CRC check
+        LatencyHistogram crc_latency;     // CRC check alone
+        LatencyHistogram decode_latency;  // frame complete -> queued for the publish thread
+        LatencyHistogram queue_latency;   // queued -> taken by the publish thread
+        LatencyHistogram publish_latency; // publish() call
+        LatencyHistogram rx_latency;      // byte arrival -> publish() returned
+        LatencyHistogram tx_latency;      // subscription callback entry -> frame handed to the TX thread
+        LatencyHistogram round_trip;      // firmware echoed command stamp -> feedback published, wall clock
+    };
+}
+
+#endif //ROS2_UART_AGENT_METRICS_HPP
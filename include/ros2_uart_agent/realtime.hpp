@@ -0,0 +1,45 @@
+#ifndef ROS2_UART_AGENT_REALTIME_HPP
+#define ROS2_UART_AGENT_REALTIME_HPP
+#include <cstddef>
+
+/*
+ * Helpers for running the agent's threads with bounded latency: CPU pinning, SCHED_FIFO
+ * priorities and keeping the process's memory resident. Everything here reports failures on
+ * std::cerr and returns false instead of aborting, so a missing capability (CAP_SYS_NICE,
+ * RLIMIT_MEMLOCK) degrades to normal scheduling rather than stopping the robot.
+ */
+namespace helpers{
+    /**
+     * Scheduling of one thread
+     */
+    struct ThreadSchedule{
+        int cpu = -1;     // core to pin the thread to, -1 to leave the affinity alone
+        int priority = 0; // SCHED_FIFO priority 1-99, 0 to keep SCHED_OTHER
+    };
+
+    /**
+     * Names the calling thread and applies schedule to it
+     * @param name thread name shown by top/ps, truncated to 15 characters
+     * @return false if the affinity or priority could not be applied
+     */
+    bool apply_thread_schedule(const ThreadSchedule &schedule, const char *name);
+
+    /**
+     * Locks all current and future pages of the process into RAM and stops malloc from returning
+     * memory to the kernel or serving large blocks with mmap, so freed memory is reused without faults
+     * @return false if mlockall failed, usually because RLIMIT_MEMLOCK is too low
+     */
+    bool lock_memory();
+
+    /**
+     * Touches size bytes of the calling thread's stack so later calls do not fault on it
+     */
+    void prefault_stack(std::size_t size);
+
+    /**
+     * Writes to every page of an already constructed buffer without changing its contents
+     */
+    void prefault(void *data, std::size_t size);
+}
+
+#endif //ROS2_UART_AGENT_REALTIME_HPP
@@ -0,0 +1,170 @@
+#ifndef ROS2_UART_AGENT_SERIAL_LINK_HPP
+#define ROS2_UART_AGENT_SERIAL_LINK_HPP
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rclcpp/rclcpp.hpp"
+#include "ros2_uart_agent/ascii_encoder.hpp"
+#include "ros2_uart_agent/binary_protocol.hpp"
+#include "ros2_uart_agent/helpers.hpp"
+#include "ros2_uart_agent/metrics.hpp"
+#include "ros2_uart_agent/realtime.hpp"
+#include "ros2_uart_agent/serial_port.hpp"
+#include "ros2_uart_agent/spsc_queue.hpp"
+#include "ros2_uart_agent/tx_scheduler.hpp"
+#include "ros2_control_interfaces/msg/joint_control.hpp"
+#include <sensor_msgs/msg/joint_state.hpp>
+#include <diagnostic_msgs/msg/diagnostic_array.hpp>
+
+namespace ros2_uart_agent{
+    using JointEstimator = helpers::JointVelocityEstimator;
+
+    /**
+     * Everything that differs between two microcontrollers served by the same agent
+     */
+    struct LinkConfig{
+        std::string name;                 // empty for the single link configured by the top level parameters
+        std::string device = "/dev/serial0";
+        unsigned int baud = 1000000;
+        helpers::Protocol protocol = helpers::Protocol::Ascii;
+        std::string control_topic = "/arm_standalone/control";
+        std::string joint_states_topic = "joint_states";
+        std::vector<std::string> joint_names;
+        std::array<helpers::JointCalibration, helpers::num_joints> calibration = helpers::default_calibration<helpers::num_joints>();
+        helpers::TxScheduler::Options tx_options; // queue_depth is also the depth of the control subscription
+        JointEstimator::Options velocity_options;
+        bool realtime = false;
+        helpers::ThreadSchedule publish_schedule;
+        std::size_t stack_prefault_bytes = 0;
+    };
+
+    /**
+     * One microcontroller: its serial port, RX parser, feedback queue and publish thread, TX scheduler,
+     * topics and metrics. Reading is driven from outside through on_readable(), so the RX side of any
+     * number of links can share one event loop thread.
+     */
+    class SerialLink{
+    public:
+        SerialLink(rclcpp::Node &node, LinkConfig config, bool use_intra_process);
+        ~SerialLink();
+        SerialLink(const SerialLink &) = delete;
+        SerialLink &operator=(const SerialLink &) = delete;
+
+        const LinkConfig &config() const { return config_; }
+
+        /**
+         * @return the port descriptor to wait on, -1 if the device could not be opened
+         */
+        int fd() const { return serial_port_.fd(); }
+
+        /**
+         * Starts the TX and publish threads
+         */
+        void start();
+
+        /**
+         * Stops the TX and publish threads and prints the RX statistics, safe to call more than once.
+         * The caller must have stopped calling on_readable() before.
+         */
+        void stop();
+
+        /**
+         * Reads whatever the port has buffered and parses it. Called from the event loop thread whenever
+         * the port is readable, never concurrently.
+         * @param hung_up the event loop reported a hangup or error, the port is dropped once drained
+         * @return false if the port failed or hung up and should no longer be polled, the reason is then
+         *         reported as the rx error
+         */
+        bool on_readable(bool hung_up = false);
+
+        /**
+         * Marks the RX side as dead in the diagnostics, e.g. after the port hung up and is no longer polled
+         * @param reason string literal used as the status message, only the first call has an effect
+         */
+        void set_rx_error(const char *reason);
+
+        /**
+         * Touches the queue, buffers and metrics so the hot path does not fault on them
+         */
+        void prefault();
+
+        /**
+         * Appends the tx and rx statuses of this link
+         */
+        void append_diagnostics(diagnostic_msgs::msg::DiagnosticArray &array, const std::string &node_name);
+
+    private:
+        using JointControl = ros2_control_interfaces::msg::JointControl;
+        using JointState = sensor_msgs::msg::JointState;
+        using JointPositions = std::array<double, helpers::num_joints>;
+
+        struct RxFrame{
+            JointPositions positions{};
+            uint32_t sec = 0;
+            uint32_t nsec = 0;
+            // metrics_clock_ns() when the bytes arrived and when the frame was queued, 0 without metrics
+            int64_t arrival_ns = 0;
+            int64_t queued_ns = 0;
+        };
+        using RxQueue = helpers::SpscQueue<RxFrame, 64>;
+
+        void topic_callback(const JointControl::SharedPtr msg);
+
+        void publish_data();
+
+        void publish_joint_state(const RxFrame &frame);
+
+        void push_frame(const JointPositions &positions, uint32_t sec, uint32_t nsec, int64_t complete_ns);
+
+        void record_round_trip(const RxFrame &frame);
+
+        void report_rx_statistics() const;
+
+        std::string status_name(const std::string &node_name, const char *direction) const;
+
+        LinkConfig config_;
+        rclcpp::Logger logger_;
+        bool use_intra_process_;
+        bool stopped_ = false;
+        helpers::SerialPort serial_port_;
+        std::unique_ptr<RxQueue> rx_queue_;
+        // only used by the event loop thread
+        helpers::FrameParser parser_{256};
+        helpers::BinaryFrameDecoder binary_decoder_;
+        helpers::AdcCalibration<helpers::num_joints> calibration_;
+        std::array<char, 4096> chunk_{};
+        // when the chunk being parsed was returned by read()
+        int64_t arrival_ns_ = 0;
+        // only used by the publish thread
+        JointEstimator velocity_estimator_;
+        // reused for every publish when the message is serialised by the middleware
+        JointState joint_state_;
+        // stamp of the last feedback frame, for the round trip measurement
+        int64_t last_feedback_stamp_ns_ = -1;
+        std::thread publish_thread_;
+        // only used by the executor thread
+        std::array<char, std::max(helpers::ascii::max_frame_size, helpers::binary::max_encoded_size)> tx_buffer_{};
+        std::unique_ptr<helpers::TxScheduler> tx_scheduler_;
+        rclcpp::Subscription<JointControl>::SharedPtr subscription_;
+        rclcpp::Publisher<JointState>::SharedPtr publisher_;
+        // written from the RX, publish, TX and executor threads, read by the diagnostics timer
+        std::unique_ptr<helpers::LinkMetrics> metrics_;
+        // state of the previous diagnostics publish, so every publish reports its own interval
+        std::vector<helpers::LatencyHistogram::Snapshot> previous_snapshots_;
+        uint64_t previous_rx_errors_ = 0;
+        // set once the port is no longer read, points to a string literal
+        std::atomic<const char *> rx_error_{nullptr};
+        // what() of the exception that ended the publish thread
+        std::mutex publish_error_mutex_;
+        std::string publish_error_;
+    };
+}
+
+#endif //ROS2_UART_AGENT_SERIAL_LINK_HPP
@@ -0,0 +1,104 @@
+#ifndef ROS2_UART_AGENT_SERIAL_PORT_HPP
+#define ROS2_UART_AGENT_SERIAL_PORT_HPP
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <sys/types.h>
+#include <sys/uio.h>
+
+namespace helpers{
+    /**
+     * Raw termios serial transport. The descriptor is non-blocking. read_some() blocks in a private
+     * epoll instance, created on first use, until data arrives or interrupt() is called. Callers that
+     * multiplex several ports wait in an EventLoop and drain them with read_available() instead.
+     */
+    class SerialPort{
+    public:
+        SerialPort() = default;
+        ~SerialPort();
+        SerialPort(const SerialPort &) = delete;
+        SerialPort &operator=(const SerialPort &) = delete;
+
+        /**
+         * Opens and configures a tty device in raw 8N1 mode
+         * @param device path of the device, e.g. /dev/serial0
+         * @param baud baud rate, must be one of the standard termios rates
+         * @return true on success, errors are printed to stderr
+         */
+        bool open(const std::string &device, unsigned int baud);
+
+        /**
+         * Takes ownership of an already opened tty descriptor (e.g. one end of a pty pair)
+         * and applies the same configuration as open()
+         */
+        bool attach(int fd, unsigned int baud);
+
+        void close();
+
+        bool is_open() const { return fd_ >= 0; }
+
+        int fd() const { return fd_; }
+
+        /**
+         * Blocks until data is available, the timeout expires or interrupt() is called
+         * @param buffer destination buffer
+         * @param size capacity of the destination buffer
+         * @param timeout_ms timeout in milliseconds, -1 to wait indefinitely
+         * @return number of bytes read, 0 on timeout or interrupt, -1 on error. A device that hung up
+         *         (e.g. unplugged USB adapter, closed pty master) is an error with errno set to EIO.
+         */
+        ssize_t read_some(char *buffer, std::size_t size, int timeout_ms = -1);
+
+        /**
+         * Single non-blocking read, for callers that wait for readiness themselves (e.g. EventLoop)
+         * @return number of bytes read, 0 if nothing is available, -1 on error or with errno set to EIO
+         *         once the device hung up
+         */
+        ssize_t read_available(char *buffer, std::size_t size);
+
+        /**
+         * Writes the whole buffer, waiting for the tty to drain if the kernel buffer is full
+         * @param blocked_ns if not null, incremented by the time spent waiting for the tty to drain
+         * @return number of bytes written, -1 on error or after cancel_writes()
+         */
+        ssize_t write_all(const char *data, std::size_t length, std::int64_t *blocked_ns = nullptr);
+
+        /**
+         * Gathers several buffers into as few writev() calls as possible, used to batch small frames
+         * @param buffers at most max_iovecs buffers
+         * @param blocked_ns if not null, incremented by the time spent waiting for the tty to drain
+         * @return number of bytes written, -1 on error or after cancel_writes()
+         */
+        ssize_t writev_all(const iovec *buffers, int count, std::int64_t *blocked_ns = nullptr);
+
+        static constexpr int max_iovecs = 16;
+
+        /**
+         * Wakes up any thread blocked in read_some(). The wake-up is sticky until it is consumed.
+         */
+        void interrupt();
+
+        /**
+         * Makes a write_all() or writev_all() blocked on a full tty return -1, so a writer thread can be
+         * joined even if the peer stopped draining the line. Every later write that would block fails
+         * as well, until the port is opened again.
+         */
+        void cancel_writes();
+
+    private:
+        bool wait_writable(std::int64_t *blocked_ns);
+        bool configure(unsigned int baud);
+        bool setup_poller();
+        void close_poller();
+
+        int fd_ = -1;
+        // created by the first read_some() or interrupt()
+        std::mutex poller_mutex_;
+        int epoll_fd_ = -1;
+        int wake_fd_ = -1;
+        int write_wake_fd_ = -1;
+    };
+}
+
+#endif //ROS2_UART_AGENT_SERIAL_PORT_HPP
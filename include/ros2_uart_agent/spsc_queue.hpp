@@ -0,0 +1,143 @@
+#ifndef ROS2_UART_AGENT_SPSC_QUEUE_HPP
+#define ROS2_UART_AGENT_SPSC_QUEUE_HPP
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <climits>
+#include <linux/futex.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace helpers{
+    /**
+     * Bounded single-producer/single-consumer ring of preallocated slots.
+     * The producer fills a slot in place (acquire/commit) and the consumer reads it in place (wait_front/pop),
+     * so no allocation happens after construction. An idle consumer sleeps on a futex instead of spinning.
+     * @tparam T slot type, it is default constructed once and reused
+     * @tparam Capacity number of slots, must be a power of two
+     */
+    template<typename T, std::size_t Capacity>
+    class SpscQueue{
+        static_assert(Capacity >= 2 && (Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+        static_assert(Capacity <= (1u << 31), "Capacity must fit the 32-bit indices");
+        static_assert(std::atomic<std::uint32_t>::is_always_lock_free, "futex word must be lock free");
+        static_assert(sizeof(std::atomic<std::uint32_t>) == sizeof(int), "futex word must be 32 bits");
+
+    public:
+        /**
+         * Producer side: obtain the next free slot
+         * @return the slot to fill, or nullptr if the ring is full, in which case the frame counts as dropped
+         */
+        T *acquire(){
+            auto tail = tail_.load(std::memory_order_relaxed);
+            if (tail - head_.load(std::memory_order_acquire) == Capacity) {
+                overflow_count_.fetch_add(1, std::memory_order_relaxed);
+                dropped_count_.fetch_add(1, std::memory_order_relaxed);
+                return nullptr;
+            }
+            return &slots_[tail & (Capacity - 1)];
+        }
+
+        /**
+         * Producer side: publish the slot returned by the last successful acquire() and wake the consumer
+         */
+        void commit(){
+            tail_.store(tail_.load(std::memory_order_relaxed) + 1, std::memory_order_seq_cst);
+            pushed_count_.fetch_add(1, std::memory_order_relaxed);
+            if (consumer_waiting_.load(std::memory_order_seq_cst)) {
+                wake();
+            }
+        }
+
+        /**
+         * Producer side: account for a frame that was discarded before it reached the ring, e.g. oversized
+         */
+        void record_drop(){
+            dropped_count_.fetch_add(1, std::memory_order_relaxed);
+        }
+
+        /**
+         * Consumer side: the oldest committed slot, or nullptr if the ring is empty
+         */
+        T *front(){
+            auto head = head_.load(std::memory_order_relaxed);
+            if (head == tail_.load(std::memory_order_acquire)) {
+                return nullptr;
+            }
+            return &slots_[head & (Capacity - 1)];
+        }
+
+        /**
+         * Consumer side: block until a slot is available or the queue is closed
+         * @return the oldest committed slot, or nullptr once the queue has been closed
+         */
+        T *wait_front(){
+            while (true) {
+                auto seq = wake_seq_.load(std::memory_order_seq_cst);
+                consumer_waiting_.store(true, std::memory_order_seq_cst);
+                // Dekker handshake with commit(): the tail load in front() is only acquire and could
+                // otherwise be satisfied before the store above is visible (e.g. LDAPR on ARMv8.3),
+                // then neither side would see the other and the wakeup would be lost
+                std::atomic_thread_fence(std::memory_order_seq_cst);
+                if (auto slot = front()) {
+                    consumer_waiting_.store(false, std::memory_order_relaxed);
+                    return slot;
+                }
+                if (closed_.load(std::memory_order_seq_cst)) {
+                    consumer_waiting_.store(false, std::memory_order_relaxed);
+                    return nullptr;
+                }
+                syscall(SYS_futex, reinterpret_cast<int *>(&wake_seq_), FUTEX_WAIT_PRIVATE,
+                        static_cast<int>(seq), nullptr, nullptr, 0);
+                consumer_waiting_.store(false, std::memory_order_relaxed);
+            }
+        }
+
+        /**
+         * Consumer side: release the slot returned by front() or wait_front()
+         */
+        void pop(){
+            head_.store(head_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+        }
+
+        /**
+         * Wakes the consumer and makes wait_front() return nullptr once the ring is drained
+         */
+        void close(){
+            closed_.store(true, std::memory_order_seq_cst);
+            wake();
+        }
+
+        std::size_t size() const{
+            return tail_.load(std::memory_order_acquire) - head_.load(std::memory_order_acquire);
+        }
+
+        static constexpr std::size_t capacity(){ return Capacity; }
+
+        std::uint64_t pushed_count() const{ return pushed_count_.load(std::memory_order_relaxed); }
+
+        std::uint64_t overflow_count() const{ return overflow_count_.load(std::memory_order_relaxed); }
+
+        std::uint64_t dropped_count() const{ return dropped_count_.load(std::memory_order_relaxed); }
+
+    private:
+        void wake(){
+            wake_seq_.fetch_add(1, std::memory_order_seq_cst);
+            syscall(SYS_futex, reinterpret_cast<int *>(&wake_seq_), FUTEX_WAKE_PRIVATE, INT_MAX, nullptr, nullptr, 0);
+        }
+
+        std::array<T, Capacity> slots_{};
+        // Producer and consumer indices live on separate cache lines to avoid false sharing
+        alignas(64) std::atomic<std::uint32_t> head_{0};
+        alignas(64) std::atomic<std::uint32_t> tail_{0};
+        alignas(64) std::atomic<std::uint32_t> wake_seq_{0};
+        std::atomic_bool consumer_waiting_{false};
+        std::atomic_bool closed_{false};
+        std::atomic<std::uint64_t> pushed_count_{0};
+        std::atomic<std::uint64_t> overflow_count_{0};
+        std::atomic<std::uint64_t> dropped_count_{0};
+    };
+}
+
+#endif //ROS2_UART_AGENT_SPSC_QUEUE_HPP
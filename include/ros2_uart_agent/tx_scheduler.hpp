@@ -0,0 +1,101 @@
+#ifndef ROS2_UART_AGENT_TX_SCHEDULER_HPP
+#define ROS2_UART_AGENT_TX_SCHEDULER_HPP
+#include <array>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include "ros2_uart_agent/metrics.hpp"
+#include "ros2_uart_agent/realtime.hpp"
+#include "ros2_uart_agent/serial_port.hpp"
+
+namespace helpers{
+    /**
+     * Decouples the subscription callback from the UART. Frames are copied into a small bounded
+     * queue and written by a dedicated thread. Every JointControl frame carries the goals of all
+     * joints, so a newer frame supersedes any frame that is still waiting: with coalescing enabled
+     * only the newest pending frame is kept, otherwise the oldest frame is dropped when the queue is full.
+     */
+    class TxScheduler{
+    public:
+        static constexpr std::size_t max_queue_depth = SerialPort::max_iovecs;
+        static constexpr std::size_t frame_capacity = 512;
+
+        struct Options{
+            std::size_t queue_depth = 4; // clamped to 1..max_queue_depth
+            bool coalesce = true;        // keep only the newest pending frame
+            bool batch = true;           // write all pending frames with one writev()
+            bool realtime = false;       // apply schedule to the writer thread and prefault its stack
+            ThreadSchedule schedule;
+            std::size_t stack_prefault_bytes = 0;
+        };
+
+        struct Stats{
+            std::size_t queue_depth = 0;       // frames waiting right now
+            std::uint64_t submitted = 0;
+            std::uint64_t written = 0;
+            std::uint64_t coalesced = 0;       // pending frames replaced by a newer one
+            std::uint64_t dropped = 0;         // frames dropped because the queue was full or too large
+            std::uint64_t write_calls = 0;
+            std::uint64_t write_errors = 0;
+            std::uint64_t write_stall_ns = 0;  // total time the writer waited for a full tty to drain
+            std::uint64_t max_write_stall_ns = 0; // longest wait of a single write call
+        };
+
+        TxScheduler(SerialPort &port, Options options);
+        ~TxScheduler();
+        TxScheduler(const TxScheduler &) = delete;
+        TxScheduler &operator=(const TxScheduler &) = delete;
+
+        void start();
+
+        /**
+         * Stops the writer thread, frames that are still pending are discarded. A write blocked on the
+         * UART is cancelled through SerialPort::cancel_writes(), so the port cannot be written to afterwards.
+         */
+        void stop();
+
+        /**
+         * Queues a complete frame for transmission, never blocks on the UART
+         * @param received_ns metrics_clock_ns() when the command was received, the time from then until
+         *                    the write completes is recorded in write_latency(). 0 to not record it,
+         *                    frames whose write fails are not recorded either.
+         * @return false if the frame was dropped because it does not fit into a slot
+         */
+        bool submit(const char *frame, std::size_t length, std::int64_t received_ns = 0);
+
+        Stats stats() const;
+
+        /**
+         * Command received -> written to the UART, for frames submitted with a timestamp
+         */
+        const LatencyHistogram &write_latency() const { return write_latency_; }
+
+    private:
+        struct Frame{
+            std::array<char, frame_capacity> data;
+            std::size_t length = 0;
+            std::int64_t received_ns = 0;
+        };
+
+        void run();
+
+        SerialPort &port_;
+        Options options_;
+        std::thread writer_;
+        mutable std::mutex mutex_;
+        std::condition_variable cv_;
+        bool stopping_ = false;
+        // ring of pending frames, guarded by mutex_
+        std::array<Frame, max_queue_depth> slots_{};
+        std::size_t head_ = 0;
+        std::size_t count_ = 0;
+        // frames owned by the writer thread while they are being written
+        std::array<Frame, max_queue_depth> in_flight_{};
+        Stats stats_{};
+        LatencyHistogram write_latency_;
+    };
+}
+
+#endif //ROS2_UART_AGENT_TX_SCHEDULER_HPP
@@ -0,0 +1,80 @@
+#ifndef ROS2_UART_AGENT_UART_AGENT_NODE_HPP
+#define ROS2_UART_AGENT_UART_AGENT_NODE_HPP
+#include <cstddef>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "rclcpp/rclcpp.hpp"
+#include "ros2_uart_agent/event_loop.hpp"
+#include "ros2_uart_agent/realtime.hpp"
+#include "ros2_uart_agent/serial_link.hpp"
+#include <diagnostic_msgs/msg/diagnostic_array.hpp>
+
+namespace ros2_uart_agent{
+    /**
+     * Bridges JointControl commands to one or more microcontrollers and their ADC feedback back to
+     * JointState. Each link has its own device, protocol and topics; the RX side of all of them is
+     * served by a single epoll thread. The threads are owned by the node, so it can be loaded as an
+     * rclcpp component into the same process as the controller and use intra-process communication.
+     */
+    class UartAgentNode : public rclcpp::Node{
+    public:
+        explicit UartAgentNode(const rclcpp::NodeOptions &options = rclcpp::NodeOptions());
+        ~UartAgentNode() override;
+
+        /**
+         * Stops the RX, publish and TX threads of every link, safe to call more than once and from any thread
+         */
+        void stop();
+
+        /**
+         * In real-time mode applies the executor_cpu and executor_priority parameters to the calling
+         * thread and prefaults its stack, does nothing otherwise. Call it from the thread that spins the node.
+         */
+        void prepare_executor_thread();
+
+    private:
+        using DiagnosticArray = diagnostic_msgs::msg::DiagnosticArray;
+
+        void publish_diagnostics();
+
+        void read_serial();
+
+        /**
+         * Declares the parameters of one link
+         * @param name empty for the unprefixed parameters, otherwise an entry of the links parameter,
+         *             used as parameter prefix and default namespace
+         * @param defaults values of the parameters the link does not set
+         */
+        LinkConfig declare_link_parameters(const std::string &name, const LinkConfig &defaults);
+
+        void declare_calibration_parameters(const std::string &prefix, LinkConfig &config);
+
+        JointEstimator::Options declare_velocity_parameters();
+
+        helpers::ThreadSchedule declare_thread_schedule(const std::string &thread, int default_priority);
+
+        void declare_realtime_parameters(helpers::TxScheduler::Options &tx_options);
+
+        void prepare_realtime();
+
+        bool use_intra_process_ = false;
+        bool realtime_ = false;
+        bool lock_memory_ = true;
+        std::size_t stack_prefault_bytes_ = 0;
+        helpers::ThreadSchedule rx_schedule_;
+        helpers::ThreadSchedule publish_schedule_;
+        helpers::ThreadSchedule executor_schedule_;
+        std::vector<std::unique_ptr<SerialLink>> links_;
+        helpers::EventLoop event_loop_;
+        std::mutex stop_mutex_;
+        std::thread rx_thread_;
+        rclcpp::Publisher<DiagnosticArray>::SharedPtr diagnostics_publisher_;
+        rclcpp::TimerBase::SharedPtr diagnostics_timer_;
+    };
+}
+
+#endif //ROS2_UART_AGENT_UART_AGENT_NODE_HPP
@@ -0,0 +1,96 @@
+#ifndef ROS2_UART_AGENT_VELOCITY_ESTIMATOR_HPP
+#define ROS2_UART_AGENT_VELOCITY_ESTIMATOR_HPP
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <string_view>
+
+namespace helpers{
+    enum class VelocityFilter : std::uint8_t{
+        MovingAverage, // mean of the finite differences over the window
+        SavitzkyGolay, // first order Savitzky-Golay, i.e. least squares slope of position over the window
+        AlphaBeta      // alpha-beta tracker, no window
+    };
+
+    /**
+     * Parses the value of the "velocity_filter" parameter: moving_average, savitzky_golay or alpha_beta
+     */
+    std::optional<VelocityFilter> velocity_filter_from_string(std::string_view name);
+
+    /**
+     * Estimates joint velocities from timestamped position samples in O(1) per sample.
+     * History lives in fixed-capacity ring buffers with running sums, nothing is allocated after construction.
+     * Time deltas are 64-bit nanoseconds. A sample whose timestamp does not increase is ignored, unless
+     * Window of them arrive in a row, which means the sender's clock restarted. That, or a gap longer
+     * than max_gap_ns (if set), restarts the estimate instead of producing a bogus velocity.
+     * @tparam NumJoints number of joints
+     * @tparam Window number of samples used by the windowed filters
+     */
+    template<std::size_t NumJoints, std::size_t Window>
+    class VelocityEstimator{
+        static_assert(NumJoints > 0, "at least one joint is required");
+        static_assert(Window >= 2, "the window needs at least two samples");
+
+    public:
+        struct Options{
+            VelocityFilter filter = VelocityFilter::MovingAverage;
+            double alpha = 0.85;               // alpha-beta position gain
+            double beta = 0.005;               // alpha-beta velocity gain
+            std::int64_t max_gap_ns = 0;       // longest gap between samples before restarting, 0 disables
+        };
+
+        explicit VelocityEstimator(Options options = Options()) : options_(options) {}
+
+        /**
+         * Adds a sample and returns the current velocity estimate in units per second
+         * @param stamp_ns sample time in nanoseconds
+         */
+        std::array<double, NumJoints> update(const std::array<double, NumJoints> &positions, std::int64_t stamp_ns);
+
+        void reset();
+
+        const Options &options() const { return options_; }
+
+        static constexpr std::size_t joint_count() { return NumJoints; }
+
+        static constexpr std::size_t window() { return Window; }
+
+    private:
+        std::array<double, NumJoints> update_moving_average(const std::array<double, NumJoints> &positions, double dt);
+
+        std::array<double, NumJoints> update_savitzky_golay(const std::array<double, NumJoints> &positions, std::int64_t stamp_ns);
+
+        std::array<double, NumJoints> update_alpha_beta(const std::array<double, NumJoints> &positions, double dt);
+
+        double relative_time(std::size_t index) const {
+            return static_cast<double>(stamps_ns_[index] - time_origin_ns_) * 1e-9;
+        }
+
+        void recompute_sums();
+
+        Options options_;
+        bool initialised_ = false;
+        std::int64_t last_stamp_ns_ = 0;
+        std::size_t stale_samples_ = 0; // non-increasing timestamps in a row
+        std::array<double, NumJoints> last_positions_{};
+        std::array<double, NumJoints> filtered_positions_{}; // alpha-beta only
+        std::array<double, NumJoints> estimate_{};
+
+        // ring buffer shared by the windowed filters, oldest sample at head_
+        std::size_t head_ = 0;
+        std::size_t count_ = 0;
+        std::array<std::array<double, NumJoints>, Window> samples_{}; // velocity or position per slot
+        std::array<std::int64_t, Window> stamps_ns_{};                 // Savitzky-Golay only
+        std::int64_t time_origin_ns_ = 0; // sums use seconds relative to this, keeps them well conditioned
+        std::array<double, NumJoints> sum_{};    // sum of samples
+        std::array<double, NumJoints> sum_tx_{}; // sum of time * position, Savitzky-Golay only
+        double sum_t_ = 0.0;
+        double sum_tt_ = 0.0;
+        std::size_t updates_since_recompute_ = 0;
+    };
+}
+
+#include "velocity_estimator.tpp"
+
+#endif //ROS2_UART_AGENT_VELOCITY_ESTIMATOR_HPP
@@ -0,0 +1,162 @@
+namespace helpers{
+    template<std::size_t NumJoints, std::size_t Window>
+    void VelocityEstimator<NumJoints, Window>::reset(){
+        initialised_ = false;
+        stale_samples_ = 0;
+        head_ = 0;
+        count_ = 0;
+        sum_ = {};
+        sum_tx_ = {};
+        sum_t_ = 0.0;
+        sum_tt_ = 0.0;
+        updates_since_recompute_ = 0;
+        estimate_ = {};
+    }
+
+    template<std::size_t NumJoints, std::size_t Window>
+    std::array<double, NumJoints>
+    VelocityEstimator<NumJoints, Window>::update(const std::array<double, NumJoints> &positions, std::int64_t stamp_ns){
+        auto dt_ns = stamp_ns - last_stamp_ns_;
+        if (initialised_ && dt_ns <= 0 && ++stale_samples_ < Window) {
+            // a duplicate or reordered frame, the estimate does not change
+            return estimate_;
+        }
+        stale_samples_ = 0;
+        if (initialised_ && (dt_ns <= 0 || (options_.max_gap_ns > 0 && dt_ns > options_.max_gap_ns))) {
+            reset();
+        }
+        if (!initialised_) {
+            initialised_ = true;
+            time_origin_ns_ = stamp_ns;
+            filtered_positions_ = positions;
+            if (options_.filter == VelocityFilter::SavitzkyGolay) {
+                update_savitzky_golay(positions, stamp_ns);
+            }
+        } else {
+            auto dt = static_cast<double>(dt_ns) * 1e-9;
+            switch (options_.filter) {
+                case VelocityFilter::SavitzkyGolay:
+                    estimate_ = update_savitzky_golay(positions, stamp_ns);
+                    break;
+                case VelocityFilter::AlphaBeta:
+                    estimate_ = update_alpha_beta(positions, dt);
+                    break;
+                default:
+                    estimate_ = update_moving_average(positions, dt);
+                    break;
+            }
+        }
+        last_stamp_ns_ = stamp_ns;
+        last_positions_ = positions;
+        return estimate_;
+    }
+
+    template<std::size_t NumJoints, std::size_t Window>
+    std::array<double, NumJoints>
+    VelocityEstimator<NumJoints, Window>::update_moving_average(const std::array<double, NumJoints> &positions, double dt){
+        auto &slot = samples_[(head_ + count_) % Window];
+        if (count_ == Window) {
+            // slot holds the oldest sample, take it out of the running sum before replacing it
+            for (std::size_t i = 0; i < NumJoints; i++) {
+                sum_[i] -= slot[i];
+            }
+            head_ = (head_ + 1) % Window;
+        } else {
+            count_++;
+        }
+        for (std::size_t i = 0; i < NumJoints; i++) {
+            slot[i] = (positions[i] - last_positions_[i]) / dt;
+            sum_[i] += slot[i];
+        }
+        if (++updates_since_recompute_ >= Window) {
+            recompute_sums();
+        }
+        std::array<double, NumJoints> average;
+        for (std::size_t i = 0; i < NumJoints; i++) {
+            average[i] = sum_[i] / static_cast<double>(count_);
+        }
+        return average;
+    }
+
+    template<std::size_t NumJoints, std::size_t Window>
+    std::array<double, NumJoints>
+    VelocityEstimator<NumJoints, Window>::update_savitzky_golay(const std::array<double, NumJoints> &positions, std::int64_t stamp_ns){
+        auto index = (head_ + count_) % Window;
+        if (count_ == Window) {
+            auto t_old = relative_time(index);
+            sum_t_ -= t_old;
+            sum_tt_ -= t_old * t_old;
+            for (std::size_t i = 0; i < NumJoints; i++) {
+                sum_[i] -= samples_[index][i];
+                sum_tx_[i] -= t_old * samples_[index][i];
+            }
+            head_ = (head_ + 1) % Window;
+        } else {
+            count_++;
+        }
+        stamps_ns_[index] = stamp_ns;
+        samples_[index] = positions;
+        auto t = relative_time(index);
+        sum_t_ += t;
+        sum_tt_ += t * t;
+        for (std::size_t i = 0; i < NumJoints; i++) {
+            sum_[i] += positions[i];
+            sum_tx_[i] += t * positions[i];
+        }
+        if (++updates_since_recompute_ >= Window) {
+            recompute_sums();
+        }
+
+        // least squares slope: (n*sum(t*x) - sum(t)*sum(x)) / (n*sum(t^2) - sum(t)^2)
+        std::array<double, NumJoints> slope{};
+        auto n = static_cast<double>(count_);
+        auto denominator = n * sum_tt_ - sum_t_ * sum_t_;
+        if (count_ < 2 || denominator <= 0.0) {
+            return slope;
+        }
+        for (std::size_t i = 0; i < NumJoints; i++) {
+            slope[i] = (n * sum_tx_[i] - sum_t_ * sum_[i]) / denominator;
+        }
+        return slope;
+    }
+
+    template<std::size_t NumJoints, std::size_t Window>
+    std::array<double, NumJoints>
+    VelocityEstimator<NumJoints, Window>::update_alpha_beta(const std::array<double, NumJoints> &positions, double dt){
+        std::array<double, NumJoints> velocity;
+        for (std::size_t i = 0; i < NumJoints; i++) {
+            auto predicted = filtered_positions_[i] + estimate_[i] * dt;
+            auto residual = positions[i] - predicted;
+            filtered_positions_[i] = predicted + options_.alpha * residual;
+            velocity[i] = estimate_[i] + options_.beta / dt * residual;
+        }
+        return velocity;
+    }
+
+    /**
+     * Rebuilds the running sums from the ring buffer once per window, which bounds floating point
+     * drift at an amortised O(1) cost. For Savitzky-Golay the time origin moves to the oldest sample.
+     */
+    template<std::size_t NumJoints, std::size_t Window>
+    void VelocityEstimator<NumJoints, Window>::recompute_sums(){
+        updates_since_recompute_ = 0;
+        bool savitzky_golay = options_.filter == VelocityFilter::SavitzkyGolay;
+        if (savitzky_golay && count_ > 0) {
+            time_origin_ns_ = stamps_ns_[head_];
+        }
+        sum_ = {};
+        sum_tx_ = {};
+        sum_t_ = 0.0;
+        sum_tt_ = 0.0;
+        for (std::size_t k = 0; k < count_; k++) {
+            auto index = (head_ + k) % Window;
+            auto t = savitzky_golay ? relative_time(index) : 0.0;
+            sum_t_ += t;
+            sum_tt_ += t * t;
+            for (std::size_t i = 0; i < NumJoints; i++) {
+                sum_[i] += samples_[index][i];
+                sum_tx_[i] += t * samples_[index][i];
+            }
+        }
+    }
+}
@@ -0,0 +1,21 @@
+#include "ros2_uart_agent/adc_decoder.hpp"
+
+namespace helpers{
+    std::uint16_t decode_adc_field(std::uint32_t field, bool &valid){
+        // mark bytes that are spaces with 0x80, exact per byte (no borrow between lanes)
+        auto spaces_xor = field ^ 0x20202020u;
+        auto spaces = ~(((spaces_xor & 0x7F7F7F7Fu) + 0x7F7F7F7Fu) | spaces_xor | 0x7F7F7F7Fu);
+        // spaces are only allowed in front of the digits and at least one digit is required
+        valid &= ((spaces & ~(spaces << 8)) & 0x80808000u) == 0;
+        valid &= spaces != 0x80808080u;
+        // turn the leading spaces into '0' so they do not change the value
+        auto digits = field | (spaces >> 3);
+        // every byte has to be in '0'..'9': high nibble 3 and no carry out of the low nibble when adding 6
+        valid &= ((digits & 0xF0F0F0F0u) | (((digits + 0x06060606u) & 0xF0F0F0F0u) >> 4)) == 0x33333333u;
+        digits &= 0x0F0F0F0Fu;
+        // combine neighbouring digits: d0 d1 d2 d3 -> (10 d0 + d1) (10 d2 + d3) -> 100 (10 d0 + d1) + 10 d2 + d3
+        digits = ((digits * 10) + (digits >> 8)) & 0x00FF00FFu;
+        digits = ((digits * 100) + (digits >> 16)) & 0x0000FFFFu;
+        return static_cast<std::uint16_t>(digits);
+    }
+}
@@ -0,0 +1,125 @@
+#include "ros2_uart_agent/ascii_encoder.hpp"
+#include "ros2_uart_agent/crc32.hpp"
+
+#include <charconv>
+#include <cmath>
+#include <cstring>
+
+namespace helpers{
+    namespace {
+        constexpr char hex_digits[] = "0123456789ABCDEF";
+
+        /**
+         * Pads the payload written between payload_begin and out with SUB to a multiple of 4,
+         * then appends ETX, the CRC of the padded payload, EOT and a null terminator
+         * @return pointer to the null terminator
+         */
+        char *finish_frame(char *payload_begin, char *out){
+            while ((out - payload_begin) % 4 != 0) {
+                *out++ = '\x1A'; // SUB character is used to pad
+            }
+            auto crc = crc32(payload_begin, out - payload_begin);
+            *out++ = '\x03';
+            out = write_hex32(out, crc);
+            *out++ = '\x04';
+            *out = '\0';
+            return out;
+        }
+
+        char *write_header(char *out, std::uint32_t sec, std::uint32_t nsec){
+            *out++ = '\x01';
+            out = write_decimal(out, sec, 7);
+            *out++ = '\t';
+            out = write_decimal(out, nsec, 9);
+            *out++ = '\x02';
+            return out;
+        }
+    }
+
+    char *write_decimal(char *out, std::uint32_t value, int min_width){
+        char digits[10];
+        int count = 0;
+        do {
+            digits[count++] = static_cast<char>('0' + value % 10);
+            value /= 10;
+        } while (value != 0);
+        for (int i = count; i < min_width; i++) {
+            *out++ = '0';
+        }
+        while (count > 0) {
+            *out++ = digits[--count];
+        }
+        return out;
+    }
+
+    char *write_hex32(char *out, std::uint32_t value){
+        for (int shift = 28; shift >= 0; shift -= 4) {
+            *out++ = hex_digits[(value >> shift) & 0xFu];
+        }
+        return out;
+    }
+
+    char *write_goal(char *out, double value){
+        if (!std::isfinite(value) || std::fabs(value) >= 1e13) {
+            return nullptr;
+        }
+        if (!std::signbit(value)) {
+            *out++ = ' ';
+        }
+#if defined(__cpp_lib_to_chars)
+        // exact decimal conversion, same rounding as printf
+        auto result = std::to_chars(out, out + ascii::max_goal_chars, value, std::chars_format::fixed, 6);
+        return result.ec == std::errc() ? result.ptr : nullptr;
+#else
+        // floating point to_chars is not available on older toolchains, round to micro units instead.
+        // This can differ from printf in the last digit for values within rounding error of a tie.
+        if (std::signbit(value)) {
+            *out++ = '-';
+        }
+        // splitting off the integer part first is exact and keeps the scaling error well below 1e-6
+        auto magnitude = std::fabs(value);
+        auto integer_part = std::floor(magnitude);
+        auto integer = static_cast<std::uint64_t>(integer_part);
+        auto fraction = static_cast<std::uint32_t>(std::llround((magnitude - integer_part) * 1e6));
+        if (fraction == 1000000) {
+            integer++;
+            fraction = 0;
+        }
+        char digits[14];
+        int count = 0;
+        do {
+            digits[count++] = static_cast<char>('0' + integer % 10);
+            integer /= 10;
+        } while (integer != 0);
+        while (count > 0) {
+            *out++ = digits[--count];
+        }
+        *out++ = '.';
+        return write_decimal(out, fraction, 6);
+#endif
+    }
+
+    std::size_t encode_ascii_command(char *buffer, const double *goals, std::size_t count,
+                                     std::uint32_t sec, std::uint32_t nsec){
+        if (count > ascii::max_goals) {
+            return 0;
+        }
+        auto out = write_header(buffer, sec, nsec);
+        auto payload_begin = out;
+        for (std::size_t i = 0; i < count; i++) {
+            out = write_goal(out, goals[i]);
+            if (out == nullptr) {
+                return 0;
+            }
+            *out++ = i + 1 == count ? '\n' : '\t';
+        }
+        return finish_frame(payload_begin, out) - buffer;
+    }
+
+    std::size_t frame_ascii_payload(char *buffer, std::string_view payload, std::uint32_t sec, std::uint32_t nsec){
+        auto out = write_header(buffer, sec, nsec);
+        auto payload_begin = out;
+        std::memcpy(out, payload.data(), payload.length());
+        return finish_frame(payload_begin, out + payload.length()) - buffer;
+    }
+}
@@ -0,0 +1,171 @@
+#include "ros2_uart_agent/binary_protocol.hpp"
+#include "ros2_uart_agent/frame_helpers.hpp"
+
+#include <cstring>
+#include <numeric>
+
+namespace helpers{
+    namespace {
+        void put_u16(unsigned char *out, std::uint16_t value){
+            out[0] = static_cast<unsigned char>(value);
+            out[1] = static_cast<unsigned char>(value >> 8);
+        }
+
+        void put_u32(unsigned char *out, std::uint32_t value){
+            out[0] = static_cast<unsigned char>(value);
+            out[1] = static_cast<unsigned char>(value >> 8);
+            out[2] = static_cast<unsigned char>(value >> 16);
+            out[3] = static_cast<unsigned char>(value >> 24);
+        }
+
+        std::uint16_t get_u16(const unsigned char *in){
+            return static_cast<std::uint16_t>(in[0] | (in[1] << 8));
+        }
+
+        std::uint32_t get_u32(const unsigned char *in){
+            return static_cast<std::uint32_t>(in[0]) | (static_cast<std::uint32_t>(in[1]) << 8) |
+                   (static_cast<std::uint32_t>(in[2]) << 16) | (static_cast<std::uint32_t>(in[3]) << 24);
+        }
+
+        std::size_t value_size(BinaryMessageType type){
+            return type == BinaryMessageType::JointCommand ? sizeof(float) : sizeof(std::uint16_t);
+        }
+
+        /**
+         * Writes the header and CRC around a body that is already in place, then COBS encodes the frame
+         */
+        std::size_t finish_frame(unsigned char *frame, std::size_t body_length, char *buffer){
+            auto crc_pos = binary::header_size + body_length;
+            put_u32(frame + crc_pos, static_cast<std::uint32_t>(CRC32(frame, frame + crc_pos)));
+            return cobs_encode(frame, crc_pos + binary::crc_size, buffer);
+        }
+
+        void put_header(unsigned char *frame, BinaryMessageType type, std::size_t count,
+                        std::uint32_t sec, std::uint32_t nsec){
+            frame[0] = static_cast<unsigned char>(type);
+            put_u32(frame + 1, sec);
+            put_u32(frame + 5, nsec);
+            frame[9] = static_cast<unsigned char>(count);
+        }
+    }
+
+    std::optional<Protocol> protocol_from_string(std::string_view name){
+        if (name == "ascii") {
+            return Protocol::Ascii;
+        }
+        if (name == "binary") {
+            return Protocol::Binary;
+        }
+        return std::nullopt;
+    }
+
+    const char *to_string(Protocol protocol){
+        return protocol == Protocol::Binary ? "binary" : "ascii";
+    }
+
+    float BinaryFrameView::goal(std::size_t index) const{
+        std::uint32_t bits = get_u32(body + index * sizeof(float));
+        float value;
+        std::memcpy(&value, &bits, sizeof(value));
+        return value;
+    }
+
+    std::uint16_t BinaryFrameView::adc_value(std::size_t index) const{
+        return get_u16(body + index * sizeof(std::uint16_t));
+    }
+
+    std::size_t cobs_encode(const unsigned char *data, std::size_t length, char *buffer){
+        std::size_t out = 1;
+        std::size_t code_pos = 0;
+        unsigned char code = 1;
+        for (std::size_t i = 0; i < length; i++) {
+            if (data[i] != 0) {
+                buffer[out++] = static_cast<char>(data[i]);
+                code++;
+            }
+            if (data[i] == 0 || code == 0xFF) {
+                buffer[code_pos] = static_cast<char>(code);
+                code = 1;
+                code_pos = out++;
+            }
+        }
+        buffer[code_pos] = static_cast<char>(code);
+        buffer[out++] = '\0';
+        return out;
+    }
+
+    std::size_t encode_binary_command(char *buffer, const double *goals, std::size_t count,
+                                      std::uint32_t sec, std::uint32_t nsec){
+        if (count > binary::max_values) {
+            return 0;
+        }
+        std::array<unsigned char, binary::max_frame_size> frame;
+        put_header(frame.data(), BinaryMessageType::JointCommand, count, sec, nsec);
+        for (std::size_t i = 0; i < count; i++) {
+            auto value = static_cast<float>(goals[i]);
+            std::uint32_t bits;
+            std::memcpy(&bits, &value, sizeof(bits));
+            put_u32(frame.data() + binary::header_size + i * sizeof(float), bits);
+        }
+        return finish_frame(frame.data(), count * sizeof(float), buffer);
+    }
+
+    std::size_t encode_binary_feedback(char *buffer, const std::uint16_t *adc_values, std::size_t count,
+                                       std::uint32_t sec, std::uint32_t nsec){
+        if (count > binary::max_values) {
+            return 0;
+        }
+        std::array<unsigned char, binary::max_frame_size> frame;
+        put_header(frame.data(), BinaryMessageType::AdcFeedback, count, sec, nsec);
+        for (std::size_t i = 0; i < count; i++) {
+            put_u16(frame.data() + binary::header_size + i * sizeof(std::uint16_t), adc_values[i]);
+        }
+        return finish_frame(frame.data(), count * sizeof(std::uint16_t), buffer);
+    }
+
+    void BinaryFrameDecoder::reset(){
+        length_ = 0;
+        block_left_ = 0;
+        zero_pending_ = false;
+        started_ = false;
+        overflowed_ = false;
+    }
+
+    std::uint64_t BinaryFrameDecoder::total_error_count() const{
+        return std::accumulate(error_counts_.cbegin(), error_counts_.cend(), std::uint64_t{0});
+    }
+
+    FrameError BinaryFrameDecoder::validate(BinaryFrameView &view) const{
+        if (length_ < binary::header_size + binary::crc_size) {
+            return FrameError::BadHeader;
+        }
+        auto type = static_cast<BinaryMessageType>(frame_[0]);
+        if (type != BinaryMessageType::JointCommand && type != BinaryMessageType::AdcFeedback) {
+            return FrameError::BadHeader;
+        }
+        auto count = frame_[9];
+        auto body_length = count * value_size(type);
+        if (count > binary::max_values || length_ != binary::header_size + body_length + binary::crc_size) {
+            return FrameError::BadHeader;
+        }
+        auto crc_pos = binary::header_size + body_length;
+        std::uint32_t crc;
+        if (metrics_enabled && crc_histogram_ != nullptr) {
+            auto crc_start = metrics_clock_ns();
+            crc = CRC32(frame_.data(), frame_.data() + crc_pos);
+            crc_histogram_->record(metrics_clock_ns() - crc_start);
+        } else {
+            crc = CRC32(frame_.data(), frame_.data() + crc_pos);
+        }
+        if (get_u32(frame_.data() + crc_pos) != crc) {
+            return FrameError::CrcMismatch;
+        }
+        view.type = type;
+        view.sec = get_u32(frame_.data() + 1);
+        view.nsec = get_u32(frame_.data() + 5);
+        view.count = count;
+        view.body = frame_.data() + binary::header_size;
+        view.body_length = body_length;
+        return FrameError::None;
+    }
+}
@@ -0,0 +1,258 @@
+#include "ros2_uart_agent/crc32.hpp"
+
+#include <cstring>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <immintrin.h>
+#define ROS2_UART_AGENT_CRC32_PCLMUL 1
+#endif
+
+#if defined(__aarch64__) || (defined(__arm__) && defined(__ARM_FEATURE_CRC32))
+#include <arm_acle.h>
+#include <sys/auxv.h>
+#include <asm/hwcap.h>
+#define ROS2_UART_AGENT_CRC32_ARMV8 1
+#endif
+
+#if defined(__aarch64__)
+#define ROS2_UART_AGENT_CRC_TARGET __attribute__((target("+crc")))
+#else
+#define ROS2_UART_AGENT_CRC_TARGET
+#endif
+
+namespace helpers{
+    namespace {
+        using detail::crc32_tables;
+
+        inline std::uint32_t load_le32(const unsigned char *p){
+            return static_cast<std::uint32_t>(p[0]) | (static_cast<std::uint32_t>(p[1]) << 8) |
+                   (static_cast<std::uint32_t>(p[2]) << 16) | (static_cast<std::uint32_t>(p[3]) << 24);
+        }
+
+        // All engines work on the pre-inverted CRC register, inversion is done once in crc32()
+        std::uint32_t crc32_bytewise(std::uint32_t crc, const unsigned char *data, std::size_t length){
+            for (std::size_t i = 0; i < length; i++) {
+                crc = crc32_tables[0][(crc ^ data[i]) & 0xFFu] ^ (crc >> 8);
+            }
+            return crc;
+        }
+
+        std::uint32_t crc32_slicing_by_8(std::uint32_t crc, const unsigned char *data, std::size_t length){
+            while (length >= 8) {
+                auto one = load_le32(data) ^ crc;
+                auto two = load_le32(data + 4);
+                crc = crc32_tables[7][one & 0xFFu] ^
+                      crc32_tables[6][(one >> 8) & 0xFFu] ^
+                      crc32_tables[5][(one >> 16) & 0xFFu] ^
+                      crc32_tables[4][one >> 24] ^
+                      crc32_tables[3][two & 0xFFu] ^
+                      crc32_tables[2][(two >> 8) & 0xFFu] ^
+                      crc32_tables[1][(two >> 16) & 0xFFu] ^
+                      crc32_tables[0][two >> 24];
+                data += 8;
+                length -= 8;
+            }
+            return crc32_bytewise(crc, data, length);
+        }
+
+#ifdef ROS2_UART_AGENT_CRC32_ARMV8
+        ROS2_UART_AGENT_CRC_TARGET
+        std::uint32_t crc32_armv8(std::uint32_t crc, const unsigned char *data, std::size_t length){
+#if defined(__aarch64__)
+            while (length >= 8) {
+                std::uint64_t value;
+                std::memcpy(&value, data, sizeof(value));
+                crc = __crc32d(crc, value);
+                data += 8;
+                length -= 8;
+            }
+#endif
+            while (length >= 4) {
+                std::uint32_t value;
+                std::memcpy(&value, data, sizeof(value));
+                crc = __crc32w(crc, value);
+                data += 4;
+                length -= 4;
+            }
+            while (length > 0) {
+                crc = __crc32b(crc, *data++);
+                length--;
+            }
+            return crc;
+        }
+
+        bool armv8_crc_supported(){
+#if defined(__aarch64__)
+            return (getauxval(AT_HWCAP) & HWCAP_CRC32) != 0;
+#else
+            return (getauxval(AT_HWCAP2) & HWCAP2_CRC32) != 0;
+#endif
+        }
+#endif
+
+#ifdef ROS2_UART_AGENT_CRC32_PCLMUL
+        __attribute__((target("pclmul,sse4.1")))
+        inline __m128i load_128(const unsigned char *p){
+            return _mm_loadu_si128(reinterpret_cast<const __m128i *>(p));
+        }
+
+        // Multiplies both halves of x by the folding constants in k and adds the next block
+        __attribute__((target("pclmul,sse4.1")))
+        inline __m128i fold_128(__m128i x, __m128i k, __m128i next){
+            auto low = _mm_clmulepi64_si128(x, k, 0x00);
+            auto high = _mm_clmulepi64_si128(x, k, 0x11);
+            return _mm_xor_si128(_mm_xor_si128(high, low), next);
+        }
+
+        /**
+         * Folds 64 byte blocks with carry-less multiplication and finishes with a Barrett reduction,
+         * following "Fast CRC Computation for Generic Polynomials Using PCLMULQDQ Instruction" (Intel).
+         * length must be at least 64 and a multiple of 16.
+         */
+        __attribute__((target("pclmul,sse4.1")))
+        std::uint32_t crc32_pclmul_blocks(std::uint32_t crc, const unsigned char *data, std::size_t length){
+            alignas(16) static const std::uint64_t k1k2[] = {0x0154442bd4, 0x01c6e41596};
+            alignas(16) static const std::uint64_t k3k4[] = {0x01751997d0, 0x00ccaa009e};
+            alignas(16) static const std::uint64_t k5k0[] = {0x0163cd6124, 0x0000000000};
+            alignas(16) static const std::uint64_t poly[] = {0x01db710641, 0x01f7011641};
+
+            auto x1 = _mm_xor_si128(load_128(data), _mm_cvtsi32_si128(static_cast<int>(crc)));
+            auto x2 = load_128(data + 0x10);
+            auto x3 = load_128(data + 0x20);
+            auto x4 = load_128(data + 0x30);
+            data += 64;
+            length -= 64;
+
+            auto k = _mm_load_si128(reinterpret_cast<const __m128i *>(k1k2));
+            while (length >= 64) {
+                x1 = fold_128(x1, k, load_128(data));
+                x2 = fold_128(x2, k, load_128(data + 0x10));
+                x3 = fold_128(x3, k, load_128(data + 0x20));
+                x4 = fold_128(x4, k, load_128(data + 0x30));
+                data += 64;
+                length -= 64;
+            }
+
+            // fold the four lanes into one 128 bit value
+            k = _mm_load_si128(reinterpret_cast<const __m128i *>(k3k4));
+            x1 = fold_128(x1, k, x2);
+            x1 = fold_128(x1, k, x3);
+            x1 = fold_128(x1, k, x4);
+            while (length >= 16) {
+                x1 = fold_128(x1, k, load_128(data));
+                data += 16;
+                length -= 16;
+            }
+
+            // fold 128 bits to 64 bits
+            x2 = _mm_clmulepi64_si128(x1, k, 0x10);
+            auto mask = _mm_setr_epi32(~0, 0, ~0, 0);
+            x1 = _mm_xor_si128(_mm_srli_si128(x1, 8), x2);
+            k = _mm_loadl_epi64(reinterpret_cast<const __m128i *>(k5k0));
+            x2 = _mm_srli_si128(x1, 4);
+            x1 = _mm_and_si128(x1, mask);
+            x1 = _mm_xor_si128(_mm_clmulepi64_si128(x1, k, 0x00), x2);
+
+            // Barrett reduction to 32 bits
+            k = _mm_load_si128(reinterpret_cast<const __m128i *>(poly));
+            x2 = _mm_and_si128(x1, mask);
+            x2 = _mm_clmulepi64_si128(x2, k, 0x10);
+            x2 = _mm_and_si128(x2, mask);
+            x2 = _mm_clmulepi64_si128(x2, k, 0x00);
+            x1 = _mm_xor_si128(x1, x2);
+            return static_cast<std::uint32_t>(_mm_extract_epi32(x1, 1));
+        }
+
+        std::uint32_t crc32_pclmul(std::uint32_t crc, const unsigned char *data, std::size_t length){
+            if (length >= 64) {
+                auto block_length = length & ~static_cast<std::size_t>(15);
+                crc = crc32_pclmul_blocks(crc, data, block_length);
+                data += block_length;
+                length -= block_length;
+            }
+            return crc32_slicing_by_8(crc, data, length);
+        }
+
+        bool pclmul_supported(){
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("pclmul") && __builtin_cpu_supports("sse4.1");
+        }
+#endif
+
+        using Crc32Function = std::uint32_t (*)(std::uint32_t, const unsigned char *, std::size_t);
+
+        Crc32Function engine_function(Crc32Engine engine){
+            switch (engine) {
+#ifdef ROS2_UART_AGENT_CRC32_ARMV8
+                case Crc32Engine::Armv8: return crc32_armv8;
+#endif
+#ifdef ROS2_UART_AGENT_CRC32_PCLMUL
+                case Crc32Engine::Pclmul: return crc32_pclmul;
+#endif
+                default: return crc32_slicing_by_8;
+            }
+        }
+
+        Crc32Engine select_engine(){
+            for (auto engine : {Crc32Engine::Armv8, Crc32Engine::Pclmul}) {
+                if (crc32_engine_supported(engine)) {
+                    return engine;
+                }
+            }
+            return Crc32Engine::SlicingBy8;
+        }
+
+        struct Dispatch{
+            Crc32Engine engine;
+            Crc32Function function;
+        };
+
+        const Dispatch &dispatch(){
+            // Selected on first use, function-local statics are initialised thread-safely
+            static const Dispatch selected = [](){
+                auto engine = select_engine();
+                return Dispatch{engine, engine_function(engine)};
+            }();
+            return selected;
+        }
+    }
+
+    const char *to_string(Crc32Engine engine){
+        switch (engine) {
+            case Crc32Engine::SlicingBy8: return "slicing-by-8";
+            case Crc32Engine::Armv8: return "armv8-crc";
+            case Crc32Engine::Pclmul: return "pclmul";
+            default: return "unknown";
+        }
+    }
+
+    bool crc32_engine_supported(Crc32Engine engine){
+        switch (engine) {
+            case Crc32Engine::SlicingBy8:
+                return true;
+#ifdef ROS2_UART_AGENT_CRC32_ARMV8
+            case Crc32Engine::Armv8:
+                return armv8_crc_supported();
+#endif
+#ifdef ROS2_UART_AGENT_CRC32_PCLMUL
+            case Crc32Engine::Pclmul:
+                return pclmul_supported();
+#endif
+            default:
+                return false;
+        }
+    }
+
+    Crc32Engine crc32_engine(){
+        return dispatch().engine;
+    }
+
+    std::uint32_t crc32(const void *data, std::size_t length, std::uint32_t crc){
+        return ~dispatch().function(~crc, static_cast<const unsigned char *>(data), length);
+    }
+
+    std::uint32_t crc32(Crc32Engine engine, const void *data, std::size_t length, std::uint32_t crc){
+        auto function = crc32_engine_supported(engine) ? engine_function(engine) : crc32_slicing_by_8;
+        return ~function(~crc, static_cast<const unsigned char *>(data), length);
+    }
+}
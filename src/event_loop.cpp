@@ -0,0 +1,86 @@
+#include "ros2_uart_agent/event_loop.hpp"
+
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <unistd.h>
+
+namespace helpers{
+    namespace {
+        void print_errno(const char *what){
+            std::cerr << "EventLoop: " << what << ": " << std::strerror(errno) << std::endl;
+        }
+    }
+
+    EventLoop::EventLoop(){
+        epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+        wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (epoll_fd_ < 0 || wake_fd_ < 0) {
+            print_errno("epoll/eventfd");
+            return;
+        }
+        epoll_event wake_event{};
+        wake_event.events = EPOLLIN;
+        wake_event.data.u64 = wake_id;
+        if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &wake_event) < 0) {
+            print_errno("epoll_ctl");
+        }
+    }
+
+    EventLoop::~EventLoop(){
+        for (int fd : {epoll_fd_, wake_fd_}) {
+            if (fd >= 0) {
+                ::close(fd);
+            }
+        }
+    }
+
+    bool EventLoop::add(int fd, std::size_t id){
+        epoll_event event{};
+        event.events = EPOLLIN;
+        event.data.u64 = id;
+        if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd, &event) < 0) {
+            print_errno("epoll_ctl");
+            return false;
+        }
+        return true;
+    }
+
+    void EventLoop::remove(int fd){
+        epoll_ctl(epoll_fd_, EPOLL_CTL_DEL, fd, nullptr);
+    }
+
+    void EventLoop::stop(){
+        std::uint64_t one = 1;
+        [[maybe_unused]] auto ignored = ::write(wake_fd_, &one, sizeof(one));
+    }
+
+    int EventLoop::wait(std::uint64_t *ids, bool *hung_up){
+        if (!is_open()) {
+            return -1;
+        }
+        epoll_event events[max_events];
+        int ready;
+        do {
+            ready = epoll_wait(epoll_fd_, events, max_events, -1);
+        } while (ready < 0 && errno == EINTR);
+        if (ready < 0) {
+            print_errno("epoll_wait");
+            return -1;
+        }
+        int count = 0;
+        for (int i = 0; i < ready; i++) {
+            if (events[i].data.u64 == wake_id) {
+                // the wake-up stays pending, so every later wait() returns straight away as well
+                return -1;
+            }
+            ids[count] = events[i].data.u64;
+            // a tty reports EPOLLIN together with the hangup, so this does not depend on EPOLLIN
+            hung_up[count] = (events[i].events & (EPOLLHUP | EPOLLERR)) != 0;
+            count++;
+        }
+        return count;
+    }
+}
@@ -0,0 +1,39 @@
+#include "ros2_uart_agent/frame_helpers.hpp"
+
+#include <string>
+#include <vector>
+
+namespace helpers{
+
+    std::array<std::uint_fast32_t, 256> generate_crc_lookup_table() noexcept
+    {
+        auto const reversed_polynomial = std::uint_fast32_t{0xEDB88320uL};
+
+        // This is a function object that calculates the checksum for a value,
+        // then increments the value, starting from zero.
+        struct byte_checksum
+        {
+            std::uint_fast32_t operator()() noexcept
+            {
+                auto checksum = static_cast<std::uint_fast32_t>(n++);
+
+                for (auto i = 0; i < 8; ++i)
+                    checksum = (checksum >> 1) ^ ((checksum & 0x1u) ? reversed_polynomial : 0);
+
+                return checksum;
+            }
+
+            unsigned n = 0;
+        };
+
+        auto table = std::array<std::uint_fast32_t, 256>{};
+        std::generate(table.begin(), table.end(), byte_checksum{});
+
+        return table;
+    }
+
+    int get_count(const std::vector<char> &array){
+        auto num_string = std::string(array.end()-6, array.end());
+        return std::stoi(num_string);
+    }
+}
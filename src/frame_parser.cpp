@@ -0,0 +1,108 @@
+#include "ros2_uart_agent/frame_parser.hpp"
+#include "ros2_uart_agent/frame_helpers.hpp"
+
+#include <numeric>
+
+namespace helpers{
+    namespace {
+        bool parse_decimal(std::string_view text, std::uint32_t &value){
+            if (text.empty() || text.length() > 10) {
+                return false;
+            }
+            std::uint64_t result = 0;
+            for (auto c : text) {
+                auto digit = static_cast<unsigned char>(c) - static_cast<unsigned char>('0');
+                if (digit > 9) {
+                    return false;
+                }
+                result = result * 10 + digit;
+            }
+            if (result > UINT32_MAX) {
+                return false;
+            }
+            value = static_cast<std::uint32_t>(result);
+            return true;
+        }
+
+        bool parse_hex32(std::string_view text, std::uint32_t &value){
+            if (text.length() != 8) {
+                return false;
+            }
+            std::uint32_t result = 0;
+            for (auto c : text) {
+                std::uint32_t nibble;
+                if (c >= '0' && c <= '9') {
+                    nibble = c - '0';
+                } else if (c >= 'A' && c <= 'F') {
+                    nibble = c - 'A' + 10;
+                } else if (c >= 'a' && c <= 'f') {
+                    nibble = c - 'a' + 10;
+                } else {
+                    return false;
+                }
+                result = (result << 4) | nibble;
+            }
+            value = result;
+            return true;
+        }
+    }
+
+    const char *to_string(FrameError error){
+        switch (error) {
+            case FrameError::None: return "none";
+            case FrameError::UnexpectedControl: return "unexpected control character";
+            case FrameError::Oversize: return "frame too long";
+            case FrameError::BadHeader: return "malformed header";
+            case FrameError::BadCrcField: return "malformed crc field";
+            case FrameError::CrcMismatch: return "crc mismatch";
+            default: return "unknown";
+        }
+    }
+
+    void FrameParser::reset(){
+        state_ = State::SeekSoh;
+        frame_length_ = 0;
+        carry_.clear();
+    }
+
+    std::uint64_t FrameParser::total_error_count() const{
+        return std::accumulate(error_counts_.cbegin(), error_counts_.cend(), std::uint64_t{0});
+    }
+
+    void FrameParser::start_frame(std::size_t length){
+        state_ = State::Header;
+        frame_length_ = length;
+        stx_offset_ = 0;
+        etx_offset_ = 0;
+        carry_.clear();
+    }
+
+    FrameError FrameParser::validate(std::string_view frame, FrameView &view) const{
+        view.header = frame.substr(1, stx_offset_ - 1);
+        view.payload = frame.substr(stx_offset_ + 1, etx_offset_ - stx_offset_ - 1);
+        view.crc = frame.substr(etx_offset_ + 1, frame.length() - etx_offset_ - 2);
+
+        auto tab = view.header.find('\t');
+        if (tab == std::string_view::npos ||
+            !parse_decimal(view.header.substr(0, tab), view.sec) ||
+            !parse_decimal(view.header.substr(tab + 1), view.nsec)) {
+            return FrameError::BadHeader;
+        }
+        std::uint32_t received_crc;
+        if (!parse_hex32(view.crc, received_crc)) {
+            return FrameError::BadCrcField;
+        }
+        std::uint32_t crc;
+        if (metrics_enabled && crc_histogram_ != nullptr) {
+            auto crc_start = metrics_clock_ns();
+            crc = CRC32(view.payload.cbegin(), view.payload.cend());
+            crc_histogram_->record(metrics_clock_ns() - crc_start);
+        } else {
+            crc = CRC32(view.payload.cbegin(), view.payload.cend());
+        }
+        if (received_crc != crc) {
+            return FrameError::CrcMismatch;
+        }
+        return FrameError::None;
+    }
+}
@@ -0,0 +1,70 @@
+#include "ros2_uart_agent/metrics.hpp"
+
+#include <cmath>
+
+namespace helpers{
+    std::uint64_t LatencyHistogram::bucket_lower_bound(std::size_t index) noexcept {
+        if (index < 2 * sub_bucket_count) {
+            return index;
+        }
+        auto exponent = static_cast<unsigned>(index / sub_bucket_count) + sub_bucket_bits - 1;
+        auto sub_bucket = index % sub_bucket_count;
+        return (sub_bucket_count + sub_bucket) << (exponent - sub_bucket_bits);
+    }
+
+    std::uint64_t LatencyHistogram::bucket_upper_bound(std::size_t index) noexcept {
+        if (index + 1 >= bucket_count) {
+            return UINT64_MAX;
+        }
+        return bucket_lower_bound(index + 1) - 1;
+    }
+
+    LatencyHistogram::Snapshot LatencyHistogram::snapshot() const {
+        Snapshot snapshot;
+        if constexpr (metrics_enabled) {
+            for (std::size_t i = 0; i < bucket_count; i++) {
+                snapshot.counts[i] = counts_[i].load(std::memory_order_relaxed);
+                snapshot.count += snapshot.counts[i];
+            }
+            snapshot.sum = sum_.load(std::memory_order_relaxed);
+        }
+        return snapshot;
+    }
+
+    LatencyHistogram::Snapshot LatencyHistogram::Snapshot::since(const Snapshot &earlier) const {
+        Snapshot interval;
+        for (std::size_t i = 0; i < bucket_count; i++) {
+            interval.counts[i] = counts[i] - earlier.counts[i];
+        }
+        interval.count = count - earlier.count;
+        interval.sum = sum - earlier.sum;
+        return interval;
+    }
+
+    std::uint64_t LatencyHistogram::Snapshot::percentile(double percentile) const {
+        if (count == 0) {
+            return 0;
+        }
+        auto rank = static_cast<std::uint64_t>(std::ceil(percentile / 100.0 * static_cast<double>(count)));
+        rank = rank == 0 ? 1 : rank;
+        std::uint64_t seen = 0;
+        for (std::size_t i = 0; i < bucket_count; i++) {
+            seen += counts[i];
+            if (seen >= rank) {
+                // middle of the bucket, at most half a sub-bucket (~3%) off
+                auto lower = bucket_lower_bound(i);
+                return i + 1 >= bucket_count ? lower : lower + (bucket_upper_bound(i) - lower) / 2;
+            }
+        }
+        return bucket_lower_bound(bucket_count - 1);
+    }
+
+    std::uint64_t LatencyHistogram::Snapshot::max() const {
+        for (std::size_t i = bucket_count; i > 0; i--) {
+            if (counts[i - 1] > 0) {
+                return i == bucket_count ? bucket_lower_bound(i - 1) : bucket_upper_bound(i - 1);
+            }
+        }
+        return 0;
+    }
+}
@@ -0,0 +1,75 @@
+#include "ros2_uart_agent/realtime.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <iostream>
+#include <string>
+#include <alloca.h>
+#include <malloc.h>
+#include <pthread.h>
+#include <sched.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+namespace helpers{
+    namespace {
+        void print_error(const char *what, int error){
+            std::cerr << "realtime: " << what << ": " << std::strerror(error) << std::endl;
+        }
+    }
+
+    bool apply_thread_schedule(const ThreadSchedule &schedule, const char *name){
+        auto self = pthread_self();
+        // the kernel limits thread names to 15 characters plus the terminator
+        pthread_setname_np(self, std::string(name).substr(0, 15).c_str());
+        bool ok = true;
+        if (schedule.cpu >= 0) {
+            cpu_set_t cpus;
+            CPU_ZERO(&cpus);
+            CPU_SET(schedule.cpu, &cpus);
+            auto error = pthread_setaffinity_np(self, sizeof(cpus), &cpus);
+            if (error != 0) {
+                print_error((std::string(name) + ": pinning to cpu " + std::to_string(schedule.cpu)).c_str(), error);
+                ok = false;
+            }
+        }
+        if (schedule.priority > 0) {
+            sched_param param{};
+            param.sched_priority = std::clamp(schedule.priority, sched_get_priority_min(SCHED_FIFO),
+                                              sched_get_priority_max(SCHED_FIFO));
+            auto error = pthread_setschedparam(self, SCHED_FIFO, &param);
+            if (error != 0) {
+                print_error((std::string(name) + ": SCHED_FIFO priority " + std::to_string(param.sched_priority)).c_str(), error);
+                ok = false;
+            }
+        }
+        return ok;
+    }
+
+    bool lock_memory(){
+        if (mlockall(MCL_CURRENT | MCL_FUTURE) != 0) {
+            print_error("mlockall", errno);
+            return false;
+        }
+        mallopt(M_TRIM_THRESHOLD, -1);
+        mallopt(M_MMAP_MAX, 0);
+        return true;
+    }
+
+    __attribute__((noinline)) void prefault_stack(std::size_t size){
+        // the frame, and with it the alloca'd block, is released on return but the pages stay mapped
+        prefault(alloca(size), size);
+    }
+
+    void prefault(void *data, std::size_t size){
+        auto page_size = static_cast<std::size_t>(sysconf(_SC_PAGESIZE));
+        auto bytes = static_cast<volatile char *>(data);
+        for (std::size_t offset = 0; offset < size; offset += page_size) {
+            bytes[offset] = bytes[offset];
+        }
+        if (size > 0) {
+            bytes[size - 1] = bytes[size - 1];
+        }
+    }
+}
@@ -0,0 +1,371 @@
+#include "ros2_uart_agent/serial_link.hpp"
+
+#include <cerrno>
+#include <chrono>
+#include <iostream>
+#include <string>
+
+namespace ros2_uart_agent{
+    namespace {
+        template<typename Decoder>
+        void report_rx_errors(const Decoder &decoder){
+            for (auto error = static_cast<std::size_t>(helpers::FrameError::UnexpectedControl);
+                 error < static_cast<std::size_t>(helpers::FrameError::Count); error++) {
+                auto frame_error = static_cast<helpers::FrameError>(error);
+                if (decoder.error_count(frame_error) > 0) {
+                    std::cout << "  " << helpers::to_string(frame_error) << ": " << decoder.error_count(frame_error) << std::endl;
+                }
+            }
+        }
+
+        void add_value(diagnostic_msgs::msg::DiagnosticStatus &status, const std::string &key, uint64_t value){
+            diagnostic_msgs::msg::KeyValue key_value;
+            key_value.key = key;
+            key_value.value = std::to_string(value);
+            status.values.push_back(std::move(key_value));
+        }
+
+        // percentiles of the values recorded since the previous call, in nanoseconds
+        void add_latency(diagnostic_msgs::msg::DiagnosticStatus &status, const std::string &name,
+                         const helpers::LatencyHistogram &histogram, helpers::LatencyHistogram::Snapshot &previous){
+            auto current = histogram.snapshot();
+            auto interval = current.since(previous);
+            previous = current;
+            add_value(status, name + ".count", interval.count);
+            add_value(status, name + ".p50_ns", interval.percentile(50));
+            add_value(status, name + ".p99_ns", interval.percentile(99));
+            add_value(status, name + ".p999_ns", interval.percentile(99.9));
+            add_value(status, name + ".max_ns", interval.max());
+        }
+    }
+
+    SerialLink::SerialLink(rclcpp::Node &node, LinkConfig config, bool use_intra_process)
+            : config_(std::move(config)),
+              logger_(node.get_logger()),
+              use_intra_process_(use_intra_process),
+              rx_queue_(std::make_unique<RxQueue>()),
+              calibration_(config_.calibration),
+              velocity_estimator_(config_.velocity_options),
+              metrics_(std::make_unique<helpers::LinkMetrics>()) {
+        if (!config_.name.empty()) {
+            logger_ = logger_.get_child(config_.name);
+        }
+        if (!serial_port_.open(config_.device, config_.baud)) {
+            std::cerr << "Unable to open serial port " << config_.device << std::endl;
+        }
+        parser_.set_crc_histogram(&metrics_->crc_latency);
+        binary_decoder_.set_crc_histogram(&metrics_->crc_latency);
+        tx_scheduler_ = std::make_unique<helpers::TxScheduler>(serial_port_, config_.tx_options);
+        // Only the newest goals matter, so do not let stale commands pile up in the executor either
+        subscription_ = node.create_subscription<JointControl>(
+                config_.control_topic, rclcpp::QoS(config_.tx_options.queue_depth),
+                [this](const JointControl::SharedPtr msg){ topic_callback(msg); });
+        publisher_ = node.create_publisher<JointState>(config_.joint_states_topic, 1000);
+        RCLCPP_INFO(logger_, "%s at %u baud, %s protocol, %s -> %s", config_.device.c_str(), config_.baud,
+                    helpers::to_string(config_.protocol),
+                    config_.control_topic.c_str(), config_.joint_states_topic.c_str());
+    }
+
+    SerialLink::~SerialLink(){
+        stop();
+    }
+
+    void SerialLink::start(){
+        tx_scheduler_->start();
+        publish_thread_ = std::thread([this](){ publish_data(); });
+    }
+
+    void SerialLink::stop(){
+        if (stopped_) {
+            return;
+        }
+        stopped_ = true;
+        // the publisher drains whatever the reader committed before it stopped
+        rx_queue_->close();
+        if (publish_thread_.joinable()) {
+            publish_thread_.join();
+        }
+        tx_scheduler_->stop();
+        report_rx_statistics();
+    }
+
+    void SerialLink::prefault(){
+        helpers::prefault(rx_queue_.get(), sizeof(RxQueue));
+        helpers::prefault(metrics_.get(), sizeof(helpers::LinkMetrics));
+        helpers::prefault(tx_scheduler_.get(), sizeof(helpers::TxScheduler));
+        helpers::prefault(tx_buffer_.data(), tx_buffer_.size());
+        helpers::prefault(chunk_.data(), chunk_.size());
+        joint_state_.name.reserve(helpers::num_joints);
+        joint_state_.position.reserve(helpers::num_joints);
+        joint_state_.velocity.reserve(helpers::num_joints);
+    }
+
+    void SerialLink::report_rx_statistics() const{
+        if (!config_.name.empty()) {
+            std::cout << config_.name << ": ";
+        }
+        if (config_.protocol == helpers::Protocol::Binary) {
+            std::cout << "Valid: " << binary_decoder_.valid_count() << ", Rejected: " << binary_decoder_.total_error_count();
+        } else {
+            std::cout << "Valid: " << parser_.valid_count() << ", Rejected: " << parser_.total_error_count();
+        }
+        std::cout << ", Dropped: " << rx_queue_->dropped_count() << " (overflow: " << rx_queue_->overflow_count() << ")" << std::endl;
+        if (config_.protocol == helpers::Protocol::Binary) {
+            report_rx_errors(binary_decoder_);
+        } else {
+            report_rx_errors(parser_);
+        }
+    }
+
+    void SerialLink::topic_callback(const JointControl::SharedPtr msg){
+        auto received_ns = helpers::metrics_clock_ns();
+        auto goal_count = std::min(msg->joints.size(), msg->goals.size());
+        std::size_t frame_length;
+        if (config_.protocol == helpers::Protocol::Binary) {
+            frame_length = helpers::encode_binary_command(tx_buffer_.data(), msg->goals.data(), goal_count,
+                                                          msg->header.stamp.sec, msg->header.stamp.nanosec);
+        } else {
+            frame_length = helpers::encode_ascii_command(tx_buffer_.data(), msg->goals.data(), goal_count,
+                                                         msg->header.stamp.sec, msg->header.stamp.nanosec);
+        }
+        if (frame_length == 0) {
+            RCLCPP_WARN(logger_, "Unable to encode JointControl message with %zu goals", goal_count);
+            return;
+        }
+        tx_scheduler_->submit(tx_buffer_.data(), frame_length, received_ns);
+        metrics_->tx_frames.add();
+        metrics_->tx_latency.record(helpers::metrics_clock_ns() - received_ns);
+    }
+
+    std::string SerialLink::status_name(const std::string &node_name, const char *direction) const{
+        if (config_.name.empty()) {
+            return node_name + ": " + direction;
+        }
+        return node_name + ": " + config_.name + " " + direction;
+    }
+
+    void SerialLink::append_diagnostics(diagnostic_msgs::msg::DiagnosticArray &array, const std::string &node_name){
+        auto stats = tx_scheduler_->stats();
+        diagnostic_msgs::msg::DiagnosticStatus status;
+        status.name = status_name(node_name, "tx");
+        status.hardware_id = config_.device;
+        status.level = stats.write_errors > 0 ? diagnostic_msgs::msg::DiagnosticStatus::ERROR
+                                              : diagnostic_msgs::msg::DiagnosticStatus::OK;
+        status.message = stats.write_errors > 0 ? "write errors" : "ok";
+        add_value(status, "queue_depth", stats.queue_depth);
+        add_value(status, "submitted", stats.submitted);
+        add_value(status, "written", stats.written);
+        add_value(status, "coalesced", stats.coalesced);
+        add_value(status, "dropped", stats.dropped);
+        add_value(status, "write_calls", stats.write_calls);
+        add_value(status, "write_errors", stats.write_errors);
+        add_value(status, "write_stall_ns", stats.write_stall_ns);
+        add_value(status, "max_write_stall_ns", stats.max_write_stall_ns);
+        if constexpr (helpers::metrics_enabled) {
+            previous_snapshots_.resize(9);
+            add_latency(status, "callback", metrics_->tx_latency, previous_snapshots_[0]);
+            add_latency(status, "write", tx_scheduler_->write_latency(), previous_snapshots_[1]);
+        }
+        array.status.push_back(std::move(status));
+
+        const auto &metrics = *metrics_;
+        diagnostic_msgs::msg::DiagnosticStatus rx_status;
+        rx_status.name = status_name(node_name, "rx");
+        rx_status.hardware_id = config_.device;
+        auto rx_errors = metrics.crc_failures.value() + metrics.framing_errors.value();
+        std::string publish_error;
+        {
+            std::lock_guard<std::mutex> lock(publish_error_mutex_);
+            publish_error = publish_error_;
+        }
+        if (!serial_port_.is_open()) {
+            rx_status.level = diagnostic_msgs::msg::DiagnosticStatus::ERROR;
+            rx_status.message = "port closed";
+        } else if (auto rx_error = rx_error_.load()) {
+            rx_status.level = diagnostic_msgs::msg::DiagnosticStatus::ERROR;
+            rx_status.message = rx_error;
+        } else if (!publish_error.empty()) {
+            rx_status.level = diagnostic_msgs::msg::DiagnosticStatus::ERROR;
+            rx_status.message = "publish failed: " + publish_error;
+        } else if (rx_errors > previous_rx_errors_) {
+            rx_status.level = diagnostic_msgs::msg::DiagnosticStatus::WARN;
+            rx_status.message = "rejected frames";
+        } else {
+            rx_status.level = diagnostic_msgs::msg::DiagnosticStatus::OK;
+            rx_status.message = "ok";
+        }
+        previous_rx_errors_ = rx_errors;
+        add_value(rx_status, "queue_overflow", rx_queue_->overflow_count());
+        if constexpr (helpers::metrics_enabled) {
+            add_value(rx_status, "bytes", metrics.rx_bytes.value());
+            add_value(rx_status, "frames", metrics.rx_frames.value());
+            add_value(rx_status, "crc_failures", metrics.crc_failures.value());
+            add_value(rx_status, "framing_errors", metrics.framing_errors.value());
+            add_value(rx_status, "decode_errors", metrics.decode_errors.value());
+            add_value(rx_status, "published", metrics.published.value());
+            add_latency(rx_status, "frame", metrics.frame_latency, previous_snapshots_[2]);
+            add_latency(rx_status, "crc", metrics.crc_latency, previous_snapshots_[3]);
+            add_latency(rx_status, "decode", metrics.decode_latency, previous_snapshots_[4]);
+            add_latency(rx_status, "queue", metrics.queue_latency, previous_snapshots_[5]);
+            add_latency(rx_status, "publish", metrics.publish_latency, previous_snapshots_[6]);
+            add_latency(rx_status, "total", metrics.rx_latency, previous_snapshots_[7]);
+            add_latency(rx_status, "round_trip", metrics.round_trip, previous_snapshots_[8]);
+        }
+        array.status.push_back(std::move(rx_status));
+    }
+
+    void SerialLink::set_rx_error(const char *reason){
+        // the first reason is the interesting one
+        const char *expected = nullptr;
+        rx_error_.compare_exchange_strong(expected, reason);
+    }
+
+    void SerialLink::publish_joint_state(const RxFrame &frame){
+        auto velocities = velocity_estimator_.update(frame.positions, static_cast<int64_t>(frame.sec) * 1000000000 + frame.nsec);
+        if (publisher_->can_loan_messages()) {
+            // the middleware owns the memory, no copy on our side and none in a shared memory transport
+            auto loaned = publisher_->borrow_loaned_message();
+            helpers::fill_joint_state_msg<helpers::num_joints>(loaned.get(), config_.joint_names, frame.positions, velocities, frame.sec, frame.nsec);
+            publisher_->publish(std::move(loaned));
+        } else if (use_intra_process_) {
+            // ownership moves to the intra-process subscription, so the message cannot be reused
+            auto msg = std::make_unique<JointState>();
+            helpers::fill_joint_state_msg<helpers::num_joints>(*msg, config_.joint_names, frame.positions, velocities, frame.sec, frame.nsec);
+            publisher_->publish(std::move(msg));
+        } else {
+            // serialised by the middleware during publish, the same storage is refilled every time
+            helpers::fill_joint_state_msg<helpers::num_joints>(joint_state_, config_.joint_names, frame.positions, velocities, frame.sec, frame.nsec);
+            publisher_->publish(joint_state_);
+        }
+    }
+
+    void SerialLink::record_round_trip(const RxFrame &frame){
+        // The firmware echoes the stamp of the last command it received. Only the first feedback frame
+        // carrying a stamp closes that command's round trip, later ones would just measure the gap
+        // between commands.
+        auto stamp_ns = static_cast<int64_t>(frame.sec) * 1000000000 + frame.nsec;
+        if (stamp_ns == last_feedback_stamp_ns_) {
+            return;
+        }
+        last_feedback_stamp_ns_ = stamp_ns;
+        auto now_ns = std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::system_clock::now().time_since_epoch()).count();
+        auto round_trip_ns = now_ns - stamp_ns;
+        // anything else is not an echo of a recent command, e.g. the firmware's own clock
+        if (round_trip_ns >= 0 && round_trip_ns < 10000000000) {
+            metrics_->round_trip.record(round_trip_ns);
+        }
+    }
+
+    void SerialLink::publish_data(){
+        if (config_.realtime) {
+            helpers::apply_thread_schedule(config_.publish_schedule, "uart_publish");
+            helpers::prefault_stack(config_.stack_prefault_bytes);
+        }
+        while(auto frame = rx_queue_->wait_front()){
+            auto taken_ns = helpers::metrics_clock_ns();
+            try {
+                publish_joint_state(*frame);
+            } catch (const std::exception &error) {
+                // a signal shut the context down before stop() reached this thread
+                if (!rclcpp::ok()) {
+                    break;
+                }
+                // leaving the thread with an exception would terminate the process, report it instead
+                RCLCPP_ERROR(logger_, "Publishing joint states failed, feedback is no longer published: %s", error.what());
+                std::lock_guard<std::mutex> lock(publish_error_mutex_);
+                publish_error_ = error.what();
+                break;
+            }
+            if constexpr (helpers::metrics_enabled) {
+                auto published_ns = helpers::metrics_clock_ns();
+                metrics_->queue_latency.record(taken_ns - frame->queued_ns);
+                metrics_->publish_latency.record(published_ns - taken_ns);
+                metrics_->rx_latency.record(published_ns - frame->arrival_ns);
+                metrics_->published.add();
+                record_round_trip(*frame);
+            }
+            rx_queue_->pop();
+        }
+    }
+
+    void SerialLink::push_frame(const JointPositions &positions, uint32_t sec, uint32_t nsec, int64_t complete_ns){
+        if (auto slot = rx_queue_->acquire()) {
+            slot->positions = positions;
+            slot->sec = sec;
+            slot->nsec = nsec;
+            slot->arrival_ns = arrival_ns_;
+            slot->queued_ns = helpers::metrics_clock_ns();
+            metrics_->decode_latency.record(slot->queued_ns - complete_ns);
+            rx_queue_->commit();
+        }
+    }
+
+    bool SerialLink::on_readable(bool hung_up){
+        auto &metrics = *metrics_;
+        auto on_ascii_frame = [this, &metrics](const helpers::FrameView &frame){
+            auto complete_ns = helpers::metrics_clock_ns();
+            metrics.rx_frames.add();
+            metrics.frame_latency.record(complete_ns - arrival_ns_);
+            auto adc_values = helpers::decode_adc_fields<helpers::num_joints>(frame.payload);
+            if (!adc_values) {
+                metrics.decode_errors.add();
+                rx_queue_->record_drop();
+                return;
+            }
+            push_frame(calibration_.apply(*adc_values), frame.sec, frame.nsec, complete_ns);
+        };
+        auto on_binary_frame = [this, &metrics](const helpers::BinaryFrameView &frame){
+            auto complete_ns = helpers::metrics_clock_ns();
+            metrics.rx_frames.add();
+            metrics.frame_latency.record(complete_ns - arrival_ns_);
+            if (frame.type != helpers::BinaryMessageType::AdcFeedback || frame.count != helpers::num_joints) {
+                metrics.decode_errors.add();
+                rx_queue_->record_drop();
+                return;
+            }
+            std::array<std::uint16_t, helpers::num_joints> adc_values;
+            for (std::size_t i = 0; i < adc_values.size(); i++) {
+                adc_values[i] = frame.adc_value(i);
+            }
+            push_frame(calibration_.apply(adc_values), frame.sec, frame.nsec, complete_ns);
+        };
+        auto on_error = [&metrics](helpers::FrameError error){
+            if (error == helpers::FrameError::CrcMismatch) {
+                metrics.crc_failures.add();
+            } else {
+                metrics.framing_errors.add();
+            }
+        };
+        // a full chunk means the kernel may hold more, keep reading until it is drained
+        for (bool first_read = true; ; first_read = false) {
+            auto bytes_read = serial_port_.read_available(chunk_.data(), chunk_.size());
+            if (bytes_read < 0) {
+                set_rx_error(errno == EIO ? "device hung up" : "read failed");
+                return false;
+            }
+            // readable without data only happens once the tty hung up, polling it again would spin
+            if (bytes_read == 0 && (first_read || hung_up)) {
+                set_rx_error("device hung up");
+                return false;
+            }
+            if (bytes_read == 0) {
+                return true;
+            }
+            arrival_ns_ = helpers::metrics_clock_ns();
+            metrics.rx_bytes.add(static_cast<uint64_t>(bytes_read));
+            if (config_.protocol == helpers::Protocol::Binary) {
+                binary_decoder_.feed(chunk_.data(), bytes_read, on_binary_frame, on_error);
+            } else {
+                parser_.feed(chunk_.data(), bytes_read, on_ascii_frame, on_error);
+            }
+            if (static_cast<std::size_t>(bytes_read) < chunk_.size()) {
+                if (hung_up) {
+                    set_rx_error("device hung up");
+                    return false;
+                }
+                return true;
+            }
+        }
+    }
+}
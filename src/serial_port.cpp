@@ -0,0 +1,342 @@
+#include "ros2_uart_agent/serial_port.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <chrono>
+#include <cstdint>
+#include <cstring>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <fcntl.h>
+#include <poll.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <termios.h>
+#include <unistd.h>
+
+namespace helpers{
+    namespace {
+        std::optional<speed_t> to_speed(unsigned int baud){
+            switch (baud) {
+                case 9600: return B9600;
+                case 19200: return B19200;
+                case 38400: return B38400;
+                case 57600: return B57600;
+                case 115200: return B115200;
+                case 230400: return B230400;
+                case 460800: return B460800;
+                case 500000: return B500000;
+                case 576000: return B576000;
+                case 921600: return B921600;
+                case 1000000: return B1000000;
+                case 1152000: return B1152000;
+                case 1500000: return B1500000;
+                case 2000000: return B2000000;
+                default: return std::nullopt;
+            }
+        }
+
+        // leaves errno untouched for the caller
+        void print_errno(const char *what){
+            auto error = errno;
+            std::cerr << "SerialPort: " << what << ": " << std::strerror(error) << std::endl;
+            errno = error;
+        }
+
+        ssize_t report_hangup(){
+            std::cerr << "SerialPort: device hung up" << std::endl;
+            errno = EIO;
+            return -1;
+        }
+    }
+
+    SerialPort::~SerialPort(){
+        close();
+    }
+
+    bool SerialPort::open(const std::string &device, unsigned int baud){
+        int fd = ::open(device.c_str(), O_RDWR | O_NOCTTY | O_NONBLOCK | O_CLOEXEC);
+        if (fd < 0) {
+            print_errno(device.c_str());
+            return false;
+        }
+        return attach(fd, baud);
+    }
+
+    bool SerialPort::attach(int fd, unsigned int baud){
+        close();
+        fd_ = fd;
+        auto flags = fcntl(fd_, F_GETFL);
+        if (flags < 0 || fcntl(fd_, F_SETFL, flags | O_NONBLOCK) < 0) {
+            print_errno("fcntl");
+            close();
+            return false;
+        }
+        write_wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (write_wake_fd_ < 0) {
+            print_errno("eventfd");
+            close();
+            return false;
+        }
+        if (!configure(baud)) {
+            close();
+            return false;
+        }
+        return true;
+    }
+
+    bool SerialPort::configure(unsigned int baud){
+        auto speed = to_speed(baud);
+        if (!speed) {
+            std::cerr << "SerialPort: unsupported baud rate " << baud << std::endl;
+            return false;
+        }
+        termios options{};
+        if (tcgetattr(fd_, &options) < 0) {
+            print_errno("tcgetattr");
+            return false;
+        }
+        cfmakeraw(&options);
+        cfsetispeed(&options, *speed);
+        cfsetospeed(&options, *speed);
+        options.c_cflag |= (CLOCAL | CREAD);
+        options.c_cflag &= ~(PARENB | CSTOPB | CSIZE | CRTSCTS);
+        options.c_cflag |= CS8;
+        // Non-blocking reads return whatever is in the kernel buffer, readiness comes from epoll
+        options.c_cc[VMIN] = 0;
+        options.c_cc[VTIME] = 0;
+        if (tcsetattr(fd_, TCSANOW, &options) < 0) {
+            print_errno("tcsetattr");
+            return false;
+        }
+        tcflush(fd_, TCIOFLUSH);
+        return true;
+    }
+
+    bool SerialPort::setup_poller(){
+        // Only read_some() and interrupt() need the poller, ports driven by an EventLoop never create it
+        std::lock_guard<std::mutex> lock(poller_mutex_);
+        if (epoll_fd_ >= 0) {
+            return true;
+        }
+        if (fd_ < 0) {
+            return false;
+        }
+        epoll_fd_ = epoll_create1(EPOLL_CLOEXEC);
+        wake_fd_ = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+        if (epoll_fd_ < 0 || wake_fd_ < 0) {
+            print_errno("epoll/eventfd");
+            close_poller();
+            return false;
+        }
+        epoll_event serial_event{};
+        serial_event.events = EPOLLIN;
+        serial_event.data.fd = fd_;
+        epoll_event wake_event{};
+        wake_event.events = EPOLLIN;
+        wake_event.data.fd = wake_fd_;
+        if (epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, fd_, &serial_event) < 0 ||
+            epoll_ctl(epoll_fd_, EPOLL_CTL_ADD, wake_fd_, &wake_event) < 0) {
+            print_errno("epoll_ctl");
+            close_poller();
+            return false;
+        }
+        return true;
+    }
+
+    void SerialPort::close_poller(){
+        for (int *fd : {&epoll_fd_, &wake_fd_}) {
+            if (*fd >= 0) {
+                ::close(*fd);
+                *fd = -1;
+            }
+        }
+    }
+
+    void SerialPort::close(){
+        {
+            std::lock_guard<std::mutex> lock(poller_mutex_);
+            close_poller();
+        }
+        for (int *fd : {&fd_, &write_wake_fd_}) {
+            if (*fd >= 0) {
+                ::close(*fd);
+                *fd = -1;
+            }
+        }
+    }
+
+    ssize_t SerialPort::read_some(char *buffer, std::size_t size, int timeout_ms){
+        if (fd_ < 0) {
+            return -1;
+        }
+        // Try the fast path first, when data is streaming in there is no need to go through epoll
+        auto count = ::read(fd_, buffer, size);
+        if (count > 0) {
+            return count;
+        }
+        if (count < 0 && errno != EAGAIN && errno != EINTR) {
+            print_errno("read");
+            return -1;
+        }
+        if (!setup_poller()) {
+            return -1;
+        }
+
+        epoll_event events[2];
+        auto ready = epoll_wait(epoll_fd_, events, 2, timeout_ms);
+        if (ready < 0) {
+            if (errno == EINTR) {
+                return 0;
+            }
+            print_errno("epoll_wait");
+            return -1;
+        }
+        bool readable = false;
+        for (int i = 0; i < ready; i++) {
+            if (events[i].data.fd == wake_fd_) {
+                std::uint64_t value;
+                [[maybe_unused]] auto ignored = ::read(wake_fd_, &value, sizeof(value));
+                return 0;
+            }
+            // EPOLLHUP and EPOLLERR come with EPOLLIN on a tty, whatever is left is read first
+            readable = true;
+        }
+        if (!readable) {
+            return 0;
+        }
+        count = ::read(fd_, buffer, size);
+        if (count < 0) {
+            if (errno == EAGAIN || errno == EINTR) {
+                return 0;
+            }
+            print_errno("read");
+            return -1;
+        }
+        if (count == 0) {
+            // reported ready but nothing to read, a hung up tty keeps doing this forever
+            return report_hangup();
+        }
+        return count;
+    }
+
+    ssize_t SerialPort::read_available(char *buffer, std::size_t size){
+        if (fd_ < 0) {
+            return -1;
+        }
+        auto count = ::read(fd_, buffer, size);
+        if (count < 0) {
+            if (errno == EAGAIN || errno == EINTR) {
+                return 0;
+            }
+            print_errno("read");
+            return -1;
+        }
+        if (count == 0) {
+            // with VMIN = 0 a raw tty returns 0 both when it is empty and once it hung up, only poll tells them apart
+            pollfd pfd{fd_, POLLIN, 0};
+            if (poll(&pfd, 1, 0) > 0 && (pfd.revents & (POLLHUP | POLLERR))) {
+                return report_hangup();
+            }
+        }
+        return count;
+    }
+
+    ssize_t SerialPort::write_all(const char *data, std::size_t length, std::int64_t *blocked_ns){
+        if (fd_ < 0) {
+            return -1;
+        }
+        std::size_t written = 0;
+        while (written < length) {
+            auto count = ::write(fd_, data + written, length - written);
+            if (count > 0) {
+                written += count;
+                continue;
+            }
+            if (count < 0 && errno == EINTR) {
+                continue;
+            }
+            if (count < 0 && errno != EAGAIN) {
+                print_errno("write");
+                return -1;
+            }
+            if (!wait_writable(blocked_ns)) {
+                return -1;
+            }
+        }
+        return static_cast<ssize_t>(written);
+    }
+
+    ssize_t SerialPort::writev_all(const iovec *buffers, int count, std::int64_t *blocked_ns){
+        if (fd_ < 0 || count < 0 || count > max_iovecs) {
+            return -1;
+        }
+        iovec pending[max_iovecs];
+        std::copy(buffers, buffers + count, pending);
+        iovec *current = pending;
+        std::size_t written = 0;
+        while (count > 0) {
+            auto result = ::writev(fd_, current, count);
+            if (result < 0) {
+                if (errno == EINTR) {
+                    continue;
+                }
+                if (errno != EAGAIN) {
+                    print_errno("writev");
+                    return -1;
+                }
+                if (!wait_writable(blocked_ns)) {
+                    return -1;
+                }
+                continue;
+            }
+            written += result;
+            // skip the buffers that were written completely and trim a partially written one
+            std::size_t remaining = result;
+            while (count > 0 && remaining >= current->iov_len) {
+                remaining -= current->iov_len;
+                current++;
+                count--;
+            }
+            if (count > 0) {
+                current->iov_base = static_cast<char *>(current->iov_base) + remaining;
+                current->iov_len -= remaining;
+            }
+        }
+        return static_cast<ssize_t>(written);
+    }
+
+    bool SerialPort::wait_writable(std::int64_t *blocked_ns){
+        pollfd fds[2] = {{fd_, POLLOUT, 0}, {write_wake_fd_, POLLIN, 0}};
+        auto start = std::chrono::steady_clock::now();
+        auto ready = poll(fds, 2, -1);
+        if (blocked_ns != nullptr) {
+            *blocked_ns += std::chrono::duration_cast<std::chrono::nanoseconds>(
+                    std::chrono::steady_clock::now() - start).count();
+        }
+        if (ready < 0) {
+            if (errno == EINTR) {
+                return true;
+            }
+            print_errno("poll");
+            return false;
+        }
+        // cancel_writes() was called, the event is left pending so later writes give up as well
+        return !(fds[1].revents & POLLIN);
+    }
+
+    void SerialPort::interrupt(){
+        if (setup_poller()) {
+            std::uint64_t value = 1;
+            [[maybe_unused]] auto ignored = ::write(wake_fd_, &value, sizeof(value));
+        }
+    }
+
+    void SerialPort::cancel_writes(){
+        if (write_wake_fd_ >= 0) {
+            std::uint64_t value = 1;
+            [[maybe_unused]] auto ignored = ::write(write_wake_fd_, &value, sizeof(value));
+        }
+    }
+}
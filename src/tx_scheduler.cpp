@@ -0,0 +1,128 @@
+#include "ros2_uart_agent/tx_scheduler.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+namespace helpers{
+    TxScheduler::TxScheduler(SerialPort &port, Options options) : port_(port), options_(options){
+        options_.queue_depth = std::clamp<std::size_t>(options_.queue_depth, 1, max_queue_depth);
+    }
+
+    TxScheduler::~TxScheduler(){
+        stop();
+    }
+
+    void TxScheduler::start(){
+        std::lock_guard<std::mutex> lck(mutex_);
+        if (writer_.joinable()) {
+            return;
+        }
+        stopping_ = false;
+        writer_ = std::thread(&TxScheduler::run, this);
+    }
+
+    void TxScheduler::stop(){
+        {
+            std::lock_guard<std::mutex> lck(mutex_);
+            stopping_ = true;
+        }
+        cv_.notify_one();
+        // the writer may be blocked on a tty that nobody drains
+        port_.cancel_writes();
+        if (writer_.joinable()) {
+            writer_.join();
+        }
+    }
+
+    bool TxScheduler::submit(const char *frame, std::size_t length, std::int64_t received_ns){
+        {
+            std::lock_guard<std::mutex> lck(mutex_);
+            stats_.submitted++;
+            if (length > frame_capacity) {
+                stats_.dropped++;
+                return false;
+            }
+            Frame *slot;
+            if (options_.coalesce && count_ > 0) {
+                // latest wins, overwrite the newest pending frame
+                slot = &slots_[(head_ + count_ - 1) % max_queue_depth];
+                stats_.coalesced++;
+            } else {
+                if (count_ == options_.queue_depth) {
+                    // the oldest pending frame is superseded by this one
+                    head_ = (head_ + 1) % max_queue_depth;
+                    count_--;
+                    stats_.dropped++;
+                }
+                slot = &slots_[(head_ + count_) % max_queue_depth];
+                count_++;
+            }
+            std::memcpy(slot->data.data(), frame, length);
+            slot->length = length;
+            slot->received_ns = received_ns;
+        }
+        cv_.notify_one();
+        return true;
+    }
+
+    TxScheduler::Stats TxScheduler::stats() const{
+        std::lock_guard<std::mutex> lck(mutex_);
+        auto stats = stats_;
+        stats.queue_depth = count_;
+        return stats;
+    }
+
+    void TxScheduler::run(){
+        if (options_.realtime) {
+            apply_thread_schedule(options_.schedule, "uart_tx");
+            prefault_stack(options_.stack_prefault_bytes);
+        }
+        std::array<iovec, max_queue_depth> buffers{};
+        std::unique_lock<std::mutex> lock(mutex_);
+        while (true) {
+            cv_.wait(lock, [this](){ return stopping_ || count_ > 0; });
+            if (stopping_) {
+                break;
+            }
+            std::size_t batch_size = options_.batch ? count_ : 1;
+            std::size_t batch_bytes = 0;
+            for (std::size_t i = 0; i < batch_size; i++) {
+                auto &slot = slots_[head_];
+                std::memcpy(in_flight_[i].data.data(), slot.data.data(), slot.length);
+                in_flight_[i].length = slot.length;
+                in_flight_[i].received_ns = slot.received_ns;
+                buffers[i].iov_base = in_flight_[i].data.data();
+                buffers[i].iov_len = slot.length;
+                batch_bytes += slot.length;
+                head_ = (head_ + 1) % max_queue_depth;
+                count_--;
+            }
+            lock.unlock();
+
+            // only the time spent waiting for the tty counts as a stall, not the write() calls themselves
+            std::int64_t stall_ns = 0;
+            auto result = port_.writev_all(buffers.data(), static_cast<int>(batch_size), &stall_ns);
+            bool complete = result == static_cast<ssize_t>(batch_bytes);
+            if constexpr (metrics_enabled) {
+                if (complete) {
+                    auto written_ns = metrics_clock_ns();
+                    for (std::size_t i = 0; i < batch_size; i++) {
+                        if (in_flight_[i].received_ns != 0) {
+                            write_latency_.record(written_ns - in_flight_[i].received_ns);
+                        }
+                    }
+                }
+            }
+
+            lock.lock();
+            stats_.write_calls++;
+            stats_.write_stall_ns += stall_ns;
+            stats_.max_write_stall_ns = std::max<std::uint64_t>(stats_.max_write_stall_ns, stall_ns);
+            if (complete) {
+                stats_.written += batch_size;
+            } else if (!stopping_) {
+                stats_.write_errors++;
+            }
+        }
+    }
+}
@@ -0,0 +1,247 @@
+#include "ros2_uart_agent/uart_agent_node.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <string>
+
+#include "rclcpp_components/register_node_macro.hpp"
+
+namespace ros2_uart_agent{
+    UartAgentNode::UartAgentNode(const rclcpp::NodeOptions &options)
+            : Node("minimal_subscriber", options),
+              use_intra_process_(options.use_intra_process_comms()) {
+        RCLCPP_INFO(this->get_logger(), "CRC32 engine: %s", helpers::to_string(helpers::crc32_engine()));
+        // velocity, threading and real-time settings are shared, everything else can differ per link
+        LinkConfig defaults;
+        defaults.velocity_options = declare_velocity_parameters();
+        declare_realtime_parameters(defaults.tx_options);
+        defaults.realtime = realtime_;
+        defaults.publish_schedule = publish_schedule_;
+        defaults.stack_prefault_bytes = stack_prefault_bytes_;
+        // the unprefixed parameters describe the only link, or the defaults of every named link
+        defaults = declare_link_parameters("", defaults);
+
+        std::vector<LinkConfig> configs;
+        auto link_names = this->declare_parameter<std::vector<std::string>>("links", std::vector<std::string>{});
+        if (link_names.empty()) {
+            configs.push_back(defaults);
+        }
+        for (const auto &name : link_names) {
+            auto duplicate = std::find_if(configs.begin(), configs.end(), [&name](const LinkConfig &config){
+                return config.name == name;
+            });
+            if (name.empty() || duplicate != configs.end()) {
+                RCLCPP_WARN(this->get_logger(), "Ignoring empty or duplicate link name '%s'", name.c_str());
+                continue;
+            }
+            auto config = declare_link_parameters(name, defaults);
+            auto shared_device = std::find_if(configs.begin(), configs.end(), [&config](const LinkConfig &other){
+                return other.device == config.device;
+            });
+            if (shared_device != configs.end()) {
+                RCLCPP_WARN(this->get_logger(), "Links '%s' and '%s' both use %s, ignoring '%s'",
+                            shared_device->name.c_str(), name.c_str(), config.device.c_str(), name.c_str());
+                continue;
+            }
+            configs.push_back(std::move(config));
+        }
+        for (auto &config : configs) {
+            links_.push_back(std::make_unique<SerialLink>(*this, std::move(config), use_intra_process_));
+        }
+        if (realtime_) {
+            prepare_realtime();
+        }
+        for (auto &link : links_) {
+            link->start();
+        }
+        diagnostics_publisher_ = this->create_publisher<DiagnosticArray>("/diagnostics", 10);
+        diagnostics_timer_ = this->create_wall_timer(std::chrono::seconds(1), [this](){ publish_diagnostics(); });
+
+        rx_thread_ = std::thread([this](){ read_serial(); });
+    }
+
+    LinkConfig UartAgentNode::declare_link_parameters(const std::string &name, const LinkConfig &defaults){
+        LinkConfig config = defaults;
+        config.name = name;
+        auto prefix = name.empty() ? std::string() : name + ".";
+        auto protocol_name = this->declare_parameter<std::string>(prefix + "protocol", helpers::to_string(defaults.protocol));
+        auto protocol = helpers::protocol_from_string(protocol_name);
+        if (!protocol) {
+            RCLCPP_WARN(this->get_logger(), "Unknown protocol '%s', falling back to %s",
+                        protocol_name.c_str(), helpers::to_string(defaults.protocol));
+        }
+        config.protocol = protocol.value_or(defaults.protocol);
+        // point device at the simulator's pty (tools/mcu_simulator) to run without hardware
+        config.device = this->declare_parameter<std::string>(prefix + "device", defaults.device);
+        config.baud = static_cast<unsigned int>(this->declare_parameter<int64_t>(prefix + "baud", defaults.baud));
+        // the subscription depth and the scheduler queue use the same validated value
+        auto queue_depth = this->declare_parameter<int64_t>(prefix + "tx_queue_depth", static_cast<int64_t>(defaults.tx_options.queue_depth));
+        if (queue_depth <= 0) {
+            RCLCPP_WARN(this->get_logger(), "%stx_queue_depth must be positive, using %zu",
+                        prefix.c_str(), defaults.tx_options.queue_depth);
+            queue_depth = static_cast<int64_t>(defaults.tx_options.queue_depth);
+        } else if (queue_depth > static_cast<int64_t>(helpers::TxScheduler::max_queue_depth)) {
+            RCLCPP_WARN(this->get_logger(), "%stx_queue_depth is limited to %zu",
+                        prefix.c_str(), helpers::TxScheduler::max_queue_depth);
+            queue_depth = static_cast<int64_t>(helpers::TxScheduler::max_queue_depth);
+        }
+        config.tx_options.queue_depth = static_cast<std::size_t>(queue_depth);
+        config.tx_options.coalesce = this->declare_parameter<bool>(prefix + "tx_coalesce", defaults.tx_options.coalesce);
+        config.tx_options.batch = this->declare_parameter<bool>(prefix + "tx_batch", defaults.tx_options.batch);
+        declare_calibration_parameters(prefix, config);
+        if (!name.empty()) {
+            auto topic_namespace = this->declare_parameter<std::string>(prefix + "namespace", "/" + name);
+            config.control_topic = topic_namespace + "/control";
+            config.joint_states_topic = topic_namespace + "/joint_states";
+        }
+        return config;
+    }
+
+    void UartAgentNode::declare_calibration_parameters(const std::string &prefix, LinkConfig &config){
+        constexpr auto count = helpers::num_joints;
+        std::vector<std::string> default_names = config.joint_names;
+        if (default_names.size() != count) {
+            default_names = helpers::default_joint_names(count);
+        }
+        std::vector<double> default_low;
+        std::vector<double> default_high;
+        std::vector<double> default_range;
+        for (const auto &joint : config.calibration) {
+            default_low.push_back(joint.adc_low);
+            default_high.push_back(joint.adc_high);
+            default_range.push_back(joint.range_deg);
+        }
+        config.joint_names = this->declare_parameter<std::vector<std::string>>(prefix + "joint_names", default_names);
+        auto adc_low = this->declare_parameter<std::vector<double>>(prefix + "adc_low", default_low);
+        auto adc_high = this->declare_parameter<std::vector<double>>(prefix + "adc_high", default_high);
+        auto range_deg = this->declare_parameter<std::vector<double>>(prefix + "joint_range_deg", default_range);
+
+        if (config.joint_names.size() != count) {
+            RCLCPP_WARN(this->get_logger(), "%sjoint_names must have %zu entries, using defaults", prefix.c_str(), count);
+            config.joint_names = default_names;
+        }
+        if (adc_low.size() != count || adc_high.size() != count || range_deg.size() != count) {
+            RCLCPP_WARN(this->get_logger(), "%sadc_low, %sadc_high and %sjoint_range_deg must have %zu entries, using defaults",
+                        prefix.c_str(), prefix.c_str(), prefix.c_str(), count);
+        } else {
+            for (std::size_t i = 0; i < count; i++) {
+                if (adc_high[i] == adc_low[i]) {
+                    RCLCPP_WARN(this->get_logger(), "%sadc_low and %sadc_high of joint %zu are equal, using defaults",
+                                prefix.c_str(), prefix.c_str(), i + 1);
+                    continue;
+                }
+                config.calibration[i] = {adc_low[i], adc_high[i], range_deg[i]};
+            }
+        }
+    }
+
+    JointEstimator::Options UartAgentNode::declare_velocity_parameters(){
+        JointEstimator::Options velocity_options;
+        auto filter_name = this->declare_parameter<std::string>("velocity_filter", "moving_average");
+        auto filter = helpers::velocity_filter_from_string(filter_name);
+        if (!filter) {
+            RCLCPP_WARN(this->get_logger(), "Unknown velocity filter '%s', falling back to moving_average", filter_name.c_str());
+        }
+        velocity_options.filter = filter.value_or(helpers::VelocityFilter::MovingAverage);
+        velocity_options.alpha = this->declare_parameter<double>("velocity_alpha", velocity_options.alpha);
+        velocity_options.beta = this->declare_parameter<double>("velocity_beta", velocity_options.beta);
+        // restart the estimate after a feedback gap longer than this, 0 (the default) never does. Set it to a
+        // few feedback periods, a value below the period would zero every published velocity.
+        auto max_gap_ms = this->declare_parameter<int64_t>("velocity_max_gap_ms", velocity_options.max_gap_ns / 1000000);
+        velocity_options.max_gap_ns = std::max<int64_t>(max_gap_ms, 0) * 1000000;
+        return velocity_options;
+    }
+
+    helpers::ThreadSchedule UartAgentNode::declare_thread_schedule(const std::string &thread, int default_priority){
+        helpers::ThreadSchedule schedule;
+        schedule.cpu = static_cast<int>(this->declare_parameter<int64_t>(thread + "_cpu", -1));
+        schedule.priority = static_cast<int>(this->declare_parameter<int64_t>(thread + "_priority", default_priority));
+        return schedule;
+    }
+
+    void UartAgentNode::declare_realtime_parameters(helpers::TxScheduler::Options &tx_options){
+        realtime_ = this->declare_parameter<bool>("realtime", false);
+        lock_memory_ = this->declare_parameter<bool>("realtime_lock_memory", true);
+        stack_prefault_bytes_ = static_cast<std::size_t>(this->declare_parameter<int64_t>("realtime_stack_prefault_kb", 64)) * 1024;
+        // RX first so bytes are drained before the UART FIFO overruns, the executor only forwards commands
+        rx_schedule_ = declare_thread_schedule("rx", 80);
+        tx_options.schedule = declare_thread_schedule("tx", 75);
+        publish_schedule_ = declare_thread_schedule("publish", 70);
+        executor_schedule_ = declare_thread_schedule("executor", 60);
+        tx_options.realtime = realtime_;
+        tx_options.stack_prefault_bytes = stack_prefault_bytes_;
+    }
+
+    void UartAgentNode::prepare_realtime(){
+        // mlockall is process wide, it also covers the other nodes of a component container
+        if (lock_memory_ && !helpers::lock_memory()) {
+            RCLCPP_WARN(this->get_logger(), "Unable to lock memory, raise RLIMIT_MEMLOCK (ulimit -l) to avoid page faults");
+        }
+        // everything the hot path touches was allocated up front, make sure it is resident
+        for (auto &link : links_) {
+            link->prefault();
+        }
+        RCLCPP_INFO(this->get_logger(), "Real-time mode: rx cpu %d prio %d, publish cpu %d prio %d, executor cpu %d prio %d",
+                    rx_schedule_.cpu, rx_schedule_.priority, publish_schedule_.cpu, publish_schedule_.priority,
+                    executor_schedule_.cpu, executor_schedule_.priority);
+    }
+
+    void UartAgentNode::prepare_executor_thread(){
+        if (!realtime_) {
+            return;
+        }
+        helpers::apply_thread_schedule(executor_schedule_, "uart_executor");
+        helpers::prefault_stack(stack_prefault_bytes_);
+    }
+
+    UartAgentNode::~UartAgentNode(){
+        stop();
+    }
+
+    void UartAgentNode::stop(){
+        // may be called from the shutdown callback and from main at the same time
+        std::lock_guard<std::mutex> lock(stop_mutex_);
+        event_loop_.stop();
+        if (rx_thread_.joinable()) {
+            rx_thread_.join();
+        }
+        for (auto &link : links_) {
+            link->stop();
+        }
+    }
+
+    void UartAgentNode::publish_diagnostics(){
+        DiagnosticArray array;
+        array.header.stamp = this->now();
+        for (auto &link : links_) {
+            link->append_diagnostics(array, this->get_name());
+        }
+        diagnostics_publisher_->publish(array);
+    }
+
+    void UartAgentNode::read_serial(){
+        if (realtime_) {
+            helpers::apply_thread_schedule(rx_schedule_, "uart_rx");
+            helpers::prefault_stack(stack_prefault_bytes_);
+        }
+        for (std::size_t i = 0; i < links_.size(); i++) {
+            if (links_[i]->fd() >= 0) {
+                event_loop_.add(links_[i]->fd(), i);
+            }
+        }
+        // one thread drains every port, each readiness event is a single non-blocking read per 4 KiB
+        event_loop_.run([this](std::size_t id, bool hung_up){
+            auto &link = *links_[id];
+            if (!link.on_readable(hung_up)) {
+                RCLCPP_WARN(this->get_logger(), "%s failed, no longer reading from it", link.config().device.c_str());
+                event_loop_.remove(link.fd());
+            }
+        });
+        // run() also returns when epoll itself fails, no link is read any more after this
+        for (auto &link : links_) {
+            link->set_rx_error("rx thread stopped");
+        }
+    }
+}
+
+RCLCPP_COMPONENTS_REGISTER_NODE(ros2_uart_agent::UartAgentNode)
@@ -0,0 +1,16 @@
+#include "ros2_uart_agent/velocity_estimator.hpp"
+
+namespace helpers{
+    std::optional<VelocityFilter> velocity_filter_from_string(std::string_view name){
+        if (name == "moving_average") {
+            return VelocityFilter::MovingAverage;
+        }
+        if (name == "savitzky_golay") {
+            return VelocityFilter::SavitzkyGolay;
+        }
+        if (name == "alpha_beta") {
+            return VelocityFilter::AlphaBeta;
+        }
+        return std::nullopt;
+    }
+}
@@ -0,0 +1,174 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+#include <cstdlib>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "ros2_uart_agent/adc_decoder.hpp"
+
+namespace {
+    // scalar version of the field contract: optional leading spaces followed by 1-4 digits
+    std::optional<std::uint16_t> scalar_decode_field(const char *field){
+        int i = 0;
+        while (i < 4 && field[i] == ' ') {
+            i++;
+        }
+        if (i == 4) {
+            return std::nullopt;
+        }
+        std::uint16_t value = 0;
+        for (; i < 4; i++) {
+            if (field[i] < '0' || field[i] > '9') {
+                return std::nullopt;
+            }
+            value = static_cast<std::uint16_t>(value * 10 + (field[i] - '0'));
+        }
+        return value;
+    }
+
+    std::optional<std::array<std::uint16_t, helpers::num_joints>> scalar_decode(const std::string &payload){
+        std::array<std::uint16_t, helpers::num_joints> values{};
+        if (payload.size() < 5 * helpers::num_joints) {
+            return std::nullopt;
+        }
+        for (std::size_t i = 0; i < helpers::num_joints; i++) {
+            auto value = scalar_decode_field(payload.data() + 5 * i);
+            if (!value || payload[5 * i + 4] != (i + 1 == helpers::num_joints ? '\n' : '\t')) {
+                return std::nullopt;
+            }
+            values[i] = *value;
+        }
+        return values;
+    }
+
+    std::uint32_t load_field(const char *field){
+        std::uint32_t word = 0;
+        for (int i = 3; i >= 0; i--) {
+            word = (word << 8) | static_cast<unsigned char>(field[i]);
+        }
+        return word;
+    }
+
+    std::string format_field(unsigned value, int leading_spaces){
+        auto digits = std::to_string(value);
+        return std::string(leading_spaces, ' ') + std::string(4 - leading_spaces - digits.size(), '0') + digits;
+    }
+}
+
+TEST(AdcDecoder, FieldMatchesScalarDecodeForEveryCombination){
+    // digits, spaces, their neighbours in the ASCII table and bytes that only differ in the high bit
+    const std::vector<char> alphabet{' ', '0', '1', '4', '5', '9', '/', ':', '\t', '\n', '+', '-', '\0',
+                                     '\x20' | '\x80', '\x30' | '\x80', '\x39' | '\x80', '\x10', 'A'};
+    char field[4];
+    for (char a : alphabet) {
+        for (char b : alphabet) {
+            for (char c : alphabet) {
+                for (char d : alphabet) {
+                    field[0] = a;
+                    field[1] = b;
+                    field[2] = c;
+                    field[3] = d;
+                    auto expected = scalar_decode_field(field);
+                    bool valid = true;
+                    auto value = helpers::decode_adc_field(load_field(field), valid);
+                    ASSERT_EQ(valid, expected.has_value()) << '"' << std::string(field, 4) << '"';
+                    if (expected) {
+                        ASSERT_EQ(value, *expected) << '"' << std::string(field, 4) << '"';
+                    }
+                }
+            }
+        }
+    }
+}
+
+TEST(AdcDecoder, FieldMatchesStrtolForEveryValue){
+    for (unsigned value = 0; value <= 9999; value++) {
+        auto digits = std::to_string(value);
+        // from zero padded to space padded like the microcontroller prints, and everything in between
+        for (int spaces = 0; spaces <= 4 - static_cast<int>(digits.size()); spaces++) {
+            auto field = format_field(value, spaces);
+            bool valid = true;
+            auto decoded = helpers::decode_adc_field(load_field(field.data()), valid);
+            ASSERT_TRUE(valid) << '"' << field << '"';
+            ASSERT_EQ(decoded, std::strtol(field.c_str(), nullptr, 10)) << '"' << field << '"';
+        }
+    }
+}
+
+TEST(AdcDecoder, PayloadMatchesScalarDecode){
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<unsigned> adc(0, 4095);
+    std::uniform_int_distribution<int> byte(0, 255);
+    const std::vector<unsigned> boundaries{0, 1, 9, 10, 99, 100, 999, 1000, 4095, 9999};
+    for (int iteration = 0; iteration < 20000; iteration++) {
+        std::string payload;
+        for (std::size_t i = 0; i < helpers::num_joints; i++) {
+            auto value = iteration % 2 == 0 ? boundaries[(iteration / 2 + i) % boundaries.size()] : adc(rng);
+            auto width = static_cast<int>(std::to_string(value).size());
+            payload += format_field(value, std::uniform_int_distribution<int>(0, 4 - width)(rng));
+            payload += i + 1 == helpers::num_joints ? '\n' : '\t';
+        }
+        // a quarter of the payloads get one byte replaced, some are cut short or have trailing bytes
+        if (iteration % 4 == 3) {
+            payload[std::uniform_int_distribution<std::size_t>(0, payload.size() - 1)(rng)] = static_cast<char>(byte(rng));
+        }
+        if (iteration % 16 == 5) {
+            payload.resize(std::uniform_int_distribution<std::size_t>(0, payload.size() - 1)(rng));
+        } else if (iteration % 16 == 7) {
+            payload += "\x03" "0A1B2C3D";
+        }
+        auto expected = scalar_decode(payload);
+        auto decoded = helpers::decode_adc_fields<helpers::num_joints>(payload);
+        ASSERT_EQ(decoded.has_value(), expected.has_value()) << payload;
+        if (expected) {
+            ASSERT_EQ(*decoded, *expected) << payload;
+        }
+    }
+}
+
+TEST(AdcDecoder, RejectsMalformedPayloads){
+    std::string payload;
+    for (std::size_t i = 0; i < helpers::num_joints; i++) {
+        payload += i + 1 == helpers::num_joints ? "4095\n" : "   0\t";
+    }
+    auto decoded = helpers::decode_adc_fields<helpers::num_joints>(payload);
+    ASSERT_TRUE(decoded.has_value());
+    EXPECT_EQ(decoded->front(), 0);
+    EXPECT_EQ(decoded->back(), 4095);
+
+    for (const char *field : {"    ", "12 3", "1 23", "-123", "+123", "12a4", " 0x1"}) {
+        auto bad = payload;
+        bad.replace(0, 4, field);
+        EXPECT_FALSE(helpers::decode_adc_fields<helpers::num_joints>(bad).has_value()) << '"' << field << '"';
+    }
+    auto bad_separator = payload;
+    bad_separator.back() = '\t';
+    EXPECT_FALSE(helpers::decode_adc_fields<helpers::num_joints>(bad_separator).has_value());
+    EXPECT_FALSE(helpers::decode_adc_fields<helpers::num_joints>(payload.substr(0, payload.size() - 1)).has_value());
+    EXPECT_FALSE(helpers::decode_adc_fields<helpers::num_joints>("").has_value());
+}
+
+TEST(AdcDecoder, CalibrationMatchesOriginalFormula){
+    // the per joint formula the scale and offset were folded from
+    auto original = [](long adc_value, long low_val, long high_val, double range_deg){
+        auto range = high_val - low_val;
+        auto mid_val = high_val + low_val;
+        double constant = range_deg * 3.14159265358979 / 360.0;
+        return ((double)adc_value * 2.0 - mid_val) / (double)range * constant;
+    };
+    helpers::AdcCalibration<helpers::num_joints> calibration;
+    auto defaults = helpers::default_calibration<helpers::num_joints>();
+    for (std::uint16_t value : {0, 1, 890, 1955, 3020, 4094, 4095}) {
+        std::array<std::uint16_t, helpers::num_joints> adc_values;
+        adc_values.fill(value);
+        auto angles = calibration.apply(adc_values);
+        for (std::size_t i = 0; i < helpers::num_joints; i++) {
+            EXPECT_NEAR(angles[i], original(value, 890, 3020, defaults[i].range_deg), 1e-12)
+                    << "joint " << i << ", adc " << value;
+        }
+    }
+}
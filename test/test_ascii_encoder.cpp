@@ -0,0 +1,172 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <charconv>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <limits>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ros2_uart_agent/ascii_encoder.hpp"
+#include "ros2_uart_agent/crc32.hpp"
+
+namespace {
+    // the sprintf based frame builder the encoder replaced: goals formatted with "% 08f", framed by generate_message
+    std::string sprintf_frame(const std::vector<double> &goals, std::uint32_t sec, std::uint32_t nsec){
+        std::array<char, 512> payload{};
+        int pos = 0;
+        for (std::size_t i = 0; i < goals.size(); i++) {
+            pos += std::sprintf(payload.data() + pos, i + 1 == goals.size() ? "% 08f\n" : "% 08f\t", goals[i]);
+        }
+        std::string_view payload_sv(payload.data(), pos);
+        auto num_padding_bytes = payload_sv.length() % 4 == 0 ? 0 : 4 - payload_sv.length() % 4;
+        std::array<char, 1024> data{};
+        data[0] = '\x01';
+        auto sec_char_count = std::sprintf(&data[1], "%07u", sec);
+        data[1 + sec_char_count] = '\t';
+        auto nsec_char_count = std::sprintf(&data[2 + sec_char_count], "%09u", nsec);
+        auto stx_char_pos = nsec_char_count + 2 + sec_char_count;
+        data[stx_char_pos] = '\x02';
+        std::copy(payload_sv.cbegin(), payload_sv.cend(), data.begin() + 1 + stx_char_pos);
+        for (std::size_t i = 0; i < num_padding_bytes; i++) {
+            data[stx_char_pos + payload_sv.length() + i + 1] = '\x1A';
+        }
+        auto padded_length = payload_sv.length() + num_padding_bytes;
+        data[stx_char_pos + padded_length + 1] = '\x03';
+        auto crc = helpers::crc32(&data[stx_char_pos + 1], padded_length);
+        auto crc_num_chars = std::sprintf(&data[stx_char_pos + padded_length + 2], "%08X", crc);
+        data[stx_char_pos + padded_length + crc_num_chars + 2] = '\x04';
+        return std::string(data.data(), stx_char_pos + padded_length + crc_num_chars + 3);
+    }
+
+    std::string encode(const std::vector<double> &goals, std::uint32_t sec, std::uint32_t nsec){
+        std::array<char, helpers::ascii::max_frame_size> buffer{};
+        auto length = helpers::encode_ascii_command(buffer.data(), goals.data(), goals.size(), sec, nsec);
+        EXPECT_EQ(buffer[length], '\0');
+        return std::string(buffer.data(), length);
+    }
+
+    std::string goal(double value){
+        std::array<char, helpers::ascii::max_goal_chars> buffer{};
+        auto end = helpers::write_goal(buffer.data(), value);
+        return end == nullptr ? std::string() : std::string(buffer.data(), end);
+    }
+
+    std::string sprintf_goal(double value){
+        char buffer[64];
+        return std::string(buffer, std::sprintf(buffer, "% 08f", value));
+    }
+}
+
+TEST(AsciiEncoder, DecimalMatchesSprintf){
+    char buffer[16];
+    char expected[16];
+    for (std::uint32_t value : {0u, 1u, 9u, 10u, 999999u, 1000000u, 9999999u, 10000000u, 123456789u,
+                                999999999u, 1000000000u, 4294967295u}) {
+        for (int width : {7, 9}) {
+            auto length = helpers::write_decimal(buffer, value, width) - buffer;
+            auto expected_length = std::sprintf(expected, width == 7 ? "%07u" : "%09u", value);
+            EXPECT_EQ(std::string(buffer, length), std::string(expected, expected_length));
+        }
+    }
+}
+
+TEST(AsciiEncoder, HexMatchesSprintf){
+    char buffer[8];
+    char expected[16];
+    std::mt19937 rng(1);
+    std::vector<std::uint32_t> values{0u, 1u, 0xAu, 0xFFu, 0x80000000u, 0xCBF43926u, 0xFFFFFFFFu};
+    for (int i = 0; i < 1000; i++) {
+        values.push_back(rng());
+    }
+    for (auto value : values) {
+        helpers::write_hex32(buffer, value);
+        std::sprintf(expected, "%08X", value);
+        EXPECT_EQ(std::string(buffer, 8), std::string(expected, 8));
+    }
+}
+
+TEST(AsciiEncoder, GoalMatchesSprintfAtBoundaries){
+    std::vector<double> values{0.0, -0.0, 1.0, -1.0, 0.5, -0.5, 1.5, -2.5, 3.14159265358979, -3.14159265358979,
+                               1e-7, -1e-7, 4e-7, 6e-7, -6e-7, 0.0000004999, 0.0000005001, 0.9999995, 0.99999949,
+                               -0.9999995, 9.9999999, 999999.9999996, 4095.0, -4095.0, 123456789012.5, -9.99e12,
+                               std::numeric_limits<double>::denorm_min(), std::numeric_limits<double>::min()};
+#if defined(__cpp_lib_to_chars)
+    // exact binary ties at the 7th decimal: odd multiples of 1/128 round half to even like printf
+    for (int k = 1; k < 256; k += 2) {
+        values.push_back(k / 128.0);
+        values.push_back(-k / 128.0);
+        values.push_back(17 + k / 128.0);
+    }
+#endif
+    for (auto value : values) {
+        EXPECT_EQ(goal(value), sprintf_goal(value)) << value;
+    }
+}
+
+TEST(AsciiEncoder, GoalMatchesSprintfForRandomValues){
+    std::mt19937_64 rng(2);
+    std::uniform_real_distribution<double> joint(-7.0, 7.0);
+    std::uniform_real_distribution<double> wide(-1e12, 1e12);
+    std::uniform_int_distribution<long> micro(-10000000, 10000000);
+    for (int i = 0; i < 100000; i++) {
+        // the nearest doubles to values half way between two micro units are the hardest for the rounding
+        auto near_tie = (micro(rng) + 0.5) / 1e6;
+        for (auto value : {joint(rng), wide(rng), near_tie}) {
+            ASSERT_EQ(goal(value), sprintf_goal(value)) << value;
+        }
+    }
+}
+
+TEST(AsciiEncoder, RejectsGoalsSprintfWouldOverflow){
+    EXPECT_EQ(goal(std::numeric_limits<double>::quiet_NaN()), "");
+    EXPECT_EQ(goal(std::numeric_limits<double>::infinity()), "");
+    EXPECT_EQ(goal(-std::numeric_limits<double>::infinity()), "");
+    EXPECT_EQ(goal(1e13), "");
+    EXPECT_EQ(goal(-1e13), "");
+    std::array<char, helpers::ascii::max_frame_size> buffer{};
+    const double goals[] = {0.1, std::nan("")};
+    EXPECT_EQ(helpers::encode_ascii_command(buffer.data(), goals, 2, 0, 0), 0u);
+    std::array<double, helpers::ascii::max_goals + 1> too_many{};
+    EXPECT_EQ(helpers::encode_ascii_command(buffer.data(), too_many.data(), too_many.size(), 0, 0), 0u);
+}
+
+TEST(AsciiEncoder, FrameMatchesSprintfFrame){
+    std::mt19937_64 rng(3);
+    std::uniform_real_distribution<double> joint(-3.2, 3.2);
+    std::uniform_int_distribution<std::size_t> count(1, helpers::ascii::max_goals);
+    const std::vector<std::vector<double>> boundaries{{0.0}, {-0.0, 0.0, 0.0}, {4095.0, -4095.0},
+                                                      {0.5, -0.5, 0.0078125}, {-9.99e12}, {1.0, 2.0, 3.0, -4.0}};
+    const std::vector<std::pair<std::uint32_t, std::uint32_t>> stamps{{0, 0}, {1, 1}, {1575000000, 999999999},
+                                                                      {4294967295u, 4294967295u}};
+    for (const auto &goals : boundaries) {
+        for (auto [sec, nsec] : stamps) {
+            EXPECT_EQ(encode(goals, sec, nsec), sprintf_frame(goals, sec, nsec));
+        }
+    }
+    for (int i = 0; i < 2000; i++) {
+        std::vector<double> goals(count(rng));
+        for (auto &value : goals) {
+            value = joint(rng);
+        }
+        auto sec = static_cast<std::uint32_t>(rng());
+        auto nsec = static_cast<std::uint32_t>(rng() % 1000000000);
+        ASSERT_EQ(encode(goals, sec, nsec), sprintf_frame(goals, sec, nsec));
+    }
+}
+
+TEST(AsciiEncoder, FramedPayloadMatchesSprintfFrame){
+    std::array<char, 256> buffer{};
+    for (const std::vector<double> &goals : {std::vector<double>{0.25}, std::vector<double>{-1.5, 2.0, 0.001}}) {
+        std::string payload;
+        for (std::size_t i = 0; i < goals.size(); i++) {
+            payload += sprintf_goal(goals[i]) + (i + 1 == goals.size() ? "\n" : "\t");
+        }
+        auto length = helpers::frame_ascii_payload(buffer.data(), payload, 42, 7);
+        EXPECT_EQ(std::string(buffer.data(), length), sprintf_frame(goals, 42, 7));
+    }
+}
@@ -0,0 +1,247 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+#include <optional>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "ros2_uart_agent/binary_protocol.hpp"
+#include "ros2_uart_agent/frame_helpers.hpp"
+
+namespace {
+    // textbook COBS decoder, data without the delimiter
+    std::optional<std::vector<unsigned char>> reference_cobs_decode(const std::string &data){
+        std::vector<unsigned char> decoded;
+        std::size_t i = 0;
+        while (i < data.size()) {
+            auto code = static_cast<unsigned char>(data[i++]);
+            if (code == 0) {
+                return std::nullopt;
+            }
+            for (int j = 1; j < code; j++) {
+                if (i >= data.size()) {
+                    return std::nullopt;
+                }
+                decoded.push_back(static_cast<unsigned char>(data[i++]));
+            }
+            if (code != 0xFF && i < data.size()) {
+                decoded.push_back(0);
+            }
+        }
+        return decoded;
+    }
+
+    std::string encode(const std::vector<unsigned char> &data){
+        std::string buffer(data.size() + data.size() / 254 + 2, '\0');
+        buffer.resize(helpers::cobs_encode(data.data(), data.size(), buffer.data()));
+        return buffer;
+    }
+
+    std::string feedback_frame(const std::vector<std::uint16_t> &adc_values, std::uint32_t sec = 1575000000,
+                               std::uint32_t nsec = 500){
+        std::string buffer(helpers::binary::max_encoded_size, '\0');
+        buffer.resize(helpers::encode_binary_feedback(buffer.data(), adc_values.data(), adc_values.size(), sec, nsec));
+        return buffer;
+    }
+
+    // the frame before byte stuffing, with the CRC recomputed unless told otherwise
+    std::string raw_frame(std::uint8_t type, std::uint8_t count, const std::vector<unsigned char> &body, bool fix_crc = true){
+        std::vector<unsigned char> frame{type, 1, 0, 0, 0, 2, 0, 0, 0, count};
+        frame.insert(frame.end(), body.cbegin(), body.cend());
+        auto crc = static_cast<std::uint32_t>(helpers::CRC32(frame.data(), frame.data() + frame.size()));
+        if (!fix_crc) {
+            crc ^= 1;
+        }
+        for (int shift = 0; shift < 32; shift += 8) {
+            frame.push_back(static_cast<unsigned char>(crc >> shift));
+        }
+        return encode(frame);
+    }
+
+    struct Collector{
+        std::vector<helpers::BinaryFrameView> frames;
+        std::vector<std::vector<std::uint16_t>> adc_values;
+        std::vector<helpers::FrameError> errors;
+
+        std::size_t feed(helpers::BinaryFrameDecoder &decoder, const std::string &data){
+            return decoder.feed(data.data(), data.size(),
+                                [this](const helpers::BinaryFrameView &view){
+                                    frames.push_back(view);
+                                    std::vector<std::uint16_t> values;
+                                    if (view.type == helpers::BinaryMessageType::AdcFeedback) {
+                                        for (std::size_t i = 0; i < view.count; i++) {
+                                            values.push_back(view.adc_value(i));
+                                        }
+                                    }
+                                    adc_values.push_back(values);
+                                },
+                                [this](helpers::FrameError error){ errors.push_back(error); });
+        }
+    };
+}
+
+TEST(Cobs, EncodesKnownVectors){
+    EXPECT_EQ(encode({}), std::string("\x01\x00", 2));
+    EXPECT_EQ(encode({0x00}), std::string("\x01\x01\x00", 3));
+    EXPECT_EQ(encode({0x00, 0x00}), std::string("\x01\x01\x01\x00", 4));
+    EXPECT_EQ(encode({0x11, 0x22, 0x00, 0x33}), std::string("\x03\x11\x22\x02\x33\x00", 6));
+    EXPECT_EQ(encode({0x11, 0x22, 0x33, 0x44}), std::string("\x05\x11\x22\x33\x44\x00", 6));
+    EXPECT_EQ(encode({0x11, 0x00, 0x00, 0x00}), std::string("\x02\x11\x01\x01\x01\x00", 6));
+}
+
+TEST(Cobs, RoundTripsZeroRunsAndLongBlocks){
+    std::vector<std::vector<unsigned char>> payloads{{}, {0}, std::vector<unsigned char>(300, 0)};
+    // runs of non-zero bytes around the 254 byte block limit, alone and followed by a zero
+    for (std::size_t length : {1u, 253u, 254u, 255u, 256u, 507u, 508u, 509u, 1000u}) {
+        std::vector<unsigned char> run(length);
+        for (std::size_t i = 0; i < length; i++) {
+            run[i] = static_cast<unsigned char>(i % 255 + 1);
+        }
+        payloads.push_back(run);
+        run.push_back(0);
+        payloads.push_back(run);
+        run.insert(run.begin(), 0);
+        payloads.push_back(run);
+    }
+    std::mt19937 rng(1);
+    for (int i = 0; i < 500; i++) {
+        std::vector<unsigned char> payload(std::uniform_int_distribution<std::size_t>(0, 1200)(rng));
+        auto zero_percent = std::uniform_int_distribution<int>(0, 100)(rng);
+        for (auto &value : payload) {
+            bool zero = std::uniform_int_distribution<int>(0, 99)(rng) < zero_percent;
+            value = zero ? 0 : static_cast<unsigned char>(std::uniform_int_distribution<int>(1, 255)(rng));
+        }
+        payloads.push_back(payload);
+    }
+    for (const auto &payload : payloads) {
+        auto encoded = encode(payload);
+        ASSERT_LE(encoded.size(), payload.size() + payload.size() / 254 + 2);
+        ASSERT_EQ(encoded.back(), '\0');
+        encoded.pop_back();
+        ASSERT_EQ(encoded.find('\0'), std::string::npos) << "length " << payload.size();
+        auto decoded = reference_cobs_decode(encoded);
+        ASSERT_TRUE(decoded.has_value()) << "length " << payload.size();
+        ASSERT_EQ(*decoded, payload) << "length " << payload.size();
+    }
+}
+
+TEST(BinaryFrameDecoder, RoundTripsFramesFullOfZeros){
+    helpers::BinaryFrameDecoder decoder;
+    Collector collector;
+    for (std::size_t count = 0; count <= helpers::binary::max_values; count++) {
+        std::vector<std::uint16_t> values(count, 0);
+        for (std::size_t i = 0; i < count; i += 3) {
+            values[i] = static_cast<std::uint16_t>(i % 2 == 0 ? 4095 : 256);
+        }
+        for (auto [sec, nsec] : {std::pair<std::uint32_t, std::uint32_t>{0, 0}, {0xFFFFFFFFu, 999999999u}}) {
+            EXPECT_EQ(collector.feed(decoder, feedback_frame(values, sec, nsec)), 1u) << "count " << count;
+            ASSERT_EQ(collector.frames.size(), collector.adc_values.size());
+            const auto &frame = collector.frames.back();
+            EXPECT_EQ(frame.type, helpers::BinaryMessageType::AdcFeedback);
+            EXPECT_EQ(frame.sec, sec);
+            EXPECT_EQ(frame.nsec, nsec);
+            EXPECT_EQ(collector.adc_values.back(), values);
+        }
+    }
+
+    std::array<char, helpers::binary::max_encoded_size> buffer{};
+    const double goals[] = {0.0, -1.5, 3.25, 0.0};
+    auto length = helpers::encode_binary_command(buffer.data(), goals, 4, 0, 7);
+    std::size_t found = 0;
+    decoder.feed(buffer.data(), length, [&found, &goals](const helpers::BinaryFrameView &view){
+        EXPECT_EQ(view.type, helpers::BinaryMessageType::JointCommand);
+        ASSERT_EQ(view.count, 4);
+        for (std::size_t i = 0; i < 4; i++) {
+            EXPECT_EQ(view.goal(i), static_cast<float>(goals[i]));
+        }
+        found++;
+    });
+    EXPECT_EQ(found, 1u);
+    EXPECT_TRUE(collector.errors.empty());
+    EXPECT_EQ(decoder.total_error_count(), 0u);
+}
+
+TEST(BinaryFrameDecoder, ResynchronisesOnStrayDelimiter){
+    helpers::BinaryFrameDecoder decoder;
+    Collector collector;
+    auto frame = feedback_frame({2011, 890, 3020});
+    // idle fill between frames is not an error
+    EXPECT_EQ(collector.feed(decoder, std::string(5, '\0') + frame + std::string(3, '\0') + frame), 2u);
+    EXPECT_TRUE(collector.errors.empty());
+    // noise ends at the next zero, the frame after it is decoded
+    EXPECT_EQ(collector.feed(decoder, std::string("\x05noise\xff\x13", 8) + '\0' + frame), 1u);
+    ASSERT_EQ(collector.errors.size(), 1u);
+    // a zero that cuts a frame in two costs that frame only, wherever it lands
+    for (std::size_t cut = 1; cut + 1 < frame.size(); cut++) {
+        auto damaged = frame;
+        damaged[cut] = '\0';
+        helpers::BinaryFrameDecoder fresh;
+        Collector cut_collector;
+        EXPECT_EQ(cut_collector.feed(fresh, damaged + frame), 1u) << "cut at " << cut;
+        EXPECT_GE(cut_collector.errors.size(), 1u) << "cut at " << cut;
+        EXPECT_EQ(fresh.valid_count(), 1u) << "cut at " << cut;
+        EXPECT_EQ(cut_collector.adc_values.back(), (std::vector<std::uint16_t>{2011, 890, 3020}));
+    }
+}
+
+TEST(BinaryFrameDecoder, RejectsTruncatedFrames){
+    auto frame = feedback_frame({2011, 890, 3020});
+    for (std::size_t length = 1; length + 1 < frame.size(); length++) {
+        helpers::BinaryFrameDecoder decoder;
+        Collector collector;
+        // the head of a frame followed by the delimiter, e.g. after a lost chunk
+        EXPECT_EQ(collector.feed(decoder, frame.substr(0, length) + '\0' + frame), 1u) << "length " << length;
+        ASSERT_EQ(collector.errors.size(), 1u) << "length " << length;
+        EXPECT_NE(collector.errors[0], helpers::FrameError::None);
+        EXPECT_EQ(decoder.total_error_count(), 1u);
+    }
+    helpers::BinaryFrameDecoder decoder;
+    Collector collector;
+    // a delimiter in the middle of a COBS block
+    EXPECT_EQ(collector.feed(decoder, std::string("\x05\x01\x02", 3) + '\0'), 0u);
+    ASSERT_EQ(collector.errors.size(), 1u);
+    EXPECT_EQ(collector.errors[0], helpers::FrameError::UnexpectedControl);
+    EXPECT_EQ(decoder.error_count(helpers::FrameError::UnexpectedControl), 1u);
+}
+
+TEST(BinaryFrameDecoder, RejectsOversizeFrames){
+    helpers::BinaryFrameDecoder decoder;
+    Collector collector;
+    auto frame = feedback_frame({1, 2, 3});
+    EXPECT_EQ(collector.feed(decoder, encode(std::vector<unsigned char>(helpers::binary::max_frame_size + 1, 0x55)) + frame), 1u);
+    // split across chunks as well
+    auto long_frame = encode(std::vector<unsigned char>(600, 0));
+    EXPECT_EQ(collector.feed(decoder, long_frame.substr(0, 300)), 0u);
+    EXPECT_EQ(collector.feed(decoder, long_frame.substr(300) + frame), 1u);
+    EXPECT_EQ(decoder.error_count(helpers::FrameError::Oversize), 2u);
+    EXPECT_EQ(decoder.total_error_count(), 2u);
+    EXPECT_EQ(decoder.valid_count(), 2u);
+}
+
+TEST(BinaryFrameDecoder, RejectsCrcMismatch){
+    helpers::BinaryFrameDecoder decoder;
+    Collector collector;
+    auto adc_feedback = static_cast<std::uint8_t>(helpers::BinaryMessageType::AdcFeedback);
+    const std::vector<unsigned char> body{0xDB, 0x07, 0x7A, 0x03, 0xCC, 0x0B};
+    EXPECT_EQ(collector.feed(decoder, raw_frame(adc_feedback, 3, body, false)), 0u);
+    EXPECT_EQ(decoder.error_count(helpers::FrameError::CrcMismatch), 1u);
+    EXPECT_EQ(collector.feed(decoder, raw_frame(adc_feedback, 3, body)), 1u);
+    EXPECT_EQ(collector.adc_values.back(), (std::vector<std::uint16_t>{2011, 890, 3020}));
+    EXPECT_EQ(decoder.total_error_count(), 1u);
+}
+
+TEST(BinaryFrameDecoder, RejectsCountThatDoesNotMatchBody){
+    helpers::BinaryFrameDecoder decoder;
+    Collector collector;
+    auto adc_feedback = static_cast<std::uint8_t>(helpers::BinaryMessageType::AdcFeedback);
+    // a correct CRC does not make up for a count that disagrees with the length, or an unknown type
+    EXPECT_EQ(collector.feed(decoder, raw_frame(adc_feedback, 3, {1, 0, 2, 0})), 0u);
+    EXPECT_EQ(collector.feed(decoder, raw_frame(adc_feedback, 2, {1, 0, 2, 0, 3, 0})), 0u);
+    EXPECT_EQ(collector.feed(decoder, raw_frame(adc_feedback, 17, std::vector<unsigned char>(34, 1))), 0u);
+    EXPECT_EQ(collector.feed(decoder, raw_frame(0x7F, 2, {1, 0, 2, 0})), 0u);
+    EXPECT_EQ(decoder.error_count(helpers::FrameError::BadHeader), 4u);
+    EXPECT_EQ(collector.feed(decoder, raw_frame(adc_feedback, 2, {1, 0, 2, 0})), 1u);
+    EXPECT_EQ(decoder.total_error_count(), 4u);
+}
@@ -0,0 +1,119 @@
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <cstdint>
+#include <numeric>
+#include <random>
+#include <string>
+#include <string_view>
+#include <vector>
+
+#include "ros2_uart_agent/crc32.hpp"
+#include "ros2_uart_agent/frame_helpers.hpp"
+
+namespace {
+    // the table driven CRC32 the engines replaced, kept verbatim as the reference
+    std::uint32_t reference_crc32(const unsigned char *first, const unsigned char *last){
+        static auto const table = helpers::generate_crc_lookup_table();
+        return static_cast<std::uint32_t>(std::uint_fast32_t{0xFFFFFFFFuL} &
+               ~std::accumulate(first, last,
+                                ~std::uint_fast32_t{0} & std::uint_fast32_t{0xFFFFFFFFuL},
+                                [](std::uint_fast32_t checksum, std::uint_fast8_t value) {
+                                    return table[(checksum ^ value) & 0xFFu] ^ (checksum >> 8);
+                                }));
+    }
+
+    std::vector<unsigned char> random_bytes(std::size_t size, std::uint32_t seed){
+        std::mt19937 rng(seed);
+        std::uniform_int_distribution<int> byte(0, 255);
+        std::vector<unsigned char> data(size);
+        for (auto &value : data) {
+            value = static_cast<unsigned char>(byte(rng));
+        }
+        return data;
+    }
+
+    class Crc32EngineTest : public ::testing::TestWithParam<helpers::Crc32Engine>{
+    protected:
+        void SetUp() override {
+            if (!helpers::crc32_engine_supported(GetParam())) {
+                GTEST_SKIP() << helpers::to_string(GetParam()) << " is not supported on this CPU";
+            }
+        }
+
+        std::uint32_t crc(const unsigned char *data, std::size_t length, std::uint32_t seed = 0) const {
+            return helpers::crc32(GetParam(), data, length, seed);
+        }
+    };
+}
+
+TEST_P(Crc32EngineTest, CheckValue){
+    std::string_view check = "123456789";
+    EXPECT_EQ(crc(reinterpret_cast<const unsigned char *>(check.data()), check.size()), 0xCBF43926u);
+    EXPECT_EQ(crc(nullptr, 0), 0u);
+}
+
+TEST_P(Crc32EngineTest, MatchesTableImplementation){
+    // padding on both sides, so every length can start at every offset of a cache line
+    constexpr std::size_t max_length = 4096;
+    constexpr std::size_t max_offset = 64;
+    auto buffer = random_bytes(max_length + 2 * max_offset, 1);
+    std::mt19937 rng(2);
+    std::uniform_int_distribution<std::size_t> length_distribution(0, max_length);
+    std::uniform_int_distribution<std::size_t> offset_distribution(0, max_offset - 1);
+    std::vector<std::size_t> lengths;
+    // every short length, where the engines switch between their bulk loop and the tail
+    for (std::size_t length = 0; length <= 256; length++) {
+        lengths.push_back(length);
+    }
+    for (int i = 0; i < 1000; i++) {
+        lengths.push_back(length_distribution(rng));
+    }
+    lengths.push_back(max_length);
+    for (auto length : lengths) {
+        auto offset = offset_distribution(rng);
+        const auto *data = buffer.data() + offset;
+        ASSERT_EQ(crc(data, length), reference_crc32(data, data + length))
+                << "length " << length << ", offset " << offset;
+    }
+}
+
+TEST_P(Crc32EngineTest, ChainsAcrossSplits){
+    auto buffer = random_bytes(4096 + 64, 3);
+    std::mt19937 rng(4);
+    for (int i = 0; i < 500; i++) {
+        auto offset = std::uniform_int_distribution<std::size_t>(0, 63)(rng);
+        auto length = std::uniform_int_distribution<std::size_t>(0, 4096)(rng);
+        auto split = std::uniform_int_distribution<std::size_t>(0, length)(rng);
+        const auto *data = buffer.data() + offset;
+        auto first = crc(data, split);
+        ASSERT_EQ(crc(data + split, length - split, first), crc(data, length))
+                << "length " << length << ", split " << split << ", offset " << offset;
+    }
+}
+
+INSTANTIATE_TEST_SUITE_P(AllEngines, Crc32EngineTest,
+                         ::testing::Values(helpers::Crc32Engine::SlicingBy8, helpers::Crc32Engine::Armv8,
+                                           helpers::Crc32Engine::Pclmul),
+                         [](const ::testing::TestParamInfo<helpers::Crc32Engine> &info){
+                             // test names may only contain letters, digits and underscores
+                             std::string name = helpers::to_string(info.param);
+                             std::replace(name.begin(), name.end(), '-', '_');
+                             return name;
+                         });
+
+TEST(Crc32, DispatchedEngineIsSupported){
+    EXPECT_TRUE(helpers::crc32_engine_supported(helpers::crc32_engine()));
+    EXPECT_TRUE(helpers::crc32_engine_supported(helpers::Crc32Engine::SlicingBy8));
+}
+
+TEST(Crc32, IteratorOverloadMatchesBufferOverload){
+    auto data = random_bytes(1000, 5);
+    std::vector<char> chars(data.cbegin(), data.cend());
+    std::string text(chars.cbegin(), chars.cend());
+    auto expected = reference_crc32(data.data(), data.data() + data.size());
+    // contiguous pointers go through the dispatched engine, other iterators through the byte table
+    EXPECT_EQ(helpers::CRC32(chars.data(), chars.data() + chars.size()), expected);
+    EXPECT_EQ(helpers::CRC32(text.cbegin(), text.cend()), expected);
+    EXPECT_EQ(helpers::crc32(chars.data(), chars.size()), expected);
+}
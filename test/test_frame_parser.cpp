@@ -0,0 +1,182 @@
+#include <gtest/gtest.h>
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "ros2_uart_agent/ascii_encoder.hpp"
+#include "ros2_uart_agent/frame_parser.hpp"
+
+namespace {
+    struct Frame{
+        std::string payload;
+        std::uint32_t sec;
+        std::uint32_t nsec;
+    };
+
+    // what the callbacks saw, the views are copied because they only live for the callback
+    struct Collector{
+        std::vector<Frame> frames;
+        std::vector<helpers::FrameError> errors;
+
+        std::size_t feed(helpers::FrameParser &parser, const std::string &data){
+            return parser.feed(data.data(), data.size(),
+                               [this](const helpers::FrameView &view){
+                                   frames.push_back({std::string(view.payload), view.sec, view.nsec});
+                               },
+                               [this](helpers::FrameError error){ errors.push_back(error); });
+        }
+    };
+
+    std::string make_frame(const std::string &payload, std::uint32_t sec = 1575000000, std::uint32_t nsec = 123456789){
+        std::string buffer(payload.size() + 40, '\0');
+        buffer.resize(helpers::frame_ascii_payload(buffer.data(), payload, sec, nsec));
+        return buffer;
+    }
+
+    // the payload the way it comes back from the parser, padded with SUB to a multiple of 4
+    std::string padded(std::string payload){
+        while (payload.size() % 4 != 0) {
+            payload += '\x1A';
+        }
+        return payload;
+    }
+
+    const std::string feedback = "2011\t 890\t3020\n";
+}
+
+TEST(FrameParser, ParsesFrame){
+    helpers::FrameParser parser;
+    Collector collector;
+    EXPECT_EQ(collector.feed(parser, make_frame(feedback, 7, 42)), 1u);
+    ASSERT_EQ(collector.frames.size(), 1u);
+    EXPECT_EQ(collector.frames[0].payload, padded(feedback));
+    EXPECT_EQ(collector.frames[0].sec, 7u);
+    EXPECT_EQ(collector.frames[0].nsec, 42u);
+    EXPECT_TRUE(collector.errors.empty());
+    EXPECT_EQ(parser.valid_count(), 1u);
+    EXPECT_EQ(parser.total_error_count(), 0u);
+}
+
+TEST(FrameParser, ResynchronisesAfterGarbage){
+    helpers::FrameParser parser;
+    Collector collector;
+    // noise before the first SOH, including stray STX/ETX/EOT, is skipped without counting an error
+    auto frame = make_frame(feedback);
+    EXPECT_EQ(collector.feed(parser, std::string("line noise \x02\x03\x04\xff\x00", 16) + frame + "\x03\x04 trailing"), 1u);
+    // a frame that lost its SOH is skipped as a whole, the next one is parsed
+    EXPECT_EQ(collector.feed(parser, frame.substr(1) + frame), 1u);
+    EXPECT_EQ(collector.frames.size(), 2u);
+    EXPECT_TRUE(collector.errors.empty());
+    EXPECT_EQ(parser.total_error_count(), 0u);
+}
+
+TEST(FrameParser, CountsEveryRejectReason){
+    auto frame = make_frame(feedback, 1575000000, 5);
+    auto stx = frame.find('\x02');
+    auto etx = frame.find('\x03');
+
+    auto bad_header = frame;
+    bad_header[3] = 'x';
+    auto missing_tab = frame;
+    missing_tab[frame.find('\t')] = '0';
+    auto bad_crc_field = frame;
+    bad_crc_field[etx + 1] = 'G';
+    auto short_crc_field = frame;
+    short_crc_field.erase(etx + 1, 1);
+    auto crc_mismatch = frame;
+    crc_mismatch[stx + 1] = '3';
+    auto etx_before_stx = frame;
+    etx_before_stx[stx] = '\x03';
+    auto eot_in_payload = frame;
+    eot_in_payload[stx + 2] = '\x04';
+    // SOH inside a frame means the previous frame was truncated
+    auto truncated = frame.substr(0, etx);
+
+    const std::vector<std::pair<std::string, helpers::FrameError>> cases{
+            {bad_header, helpers::FrameError::BadHeader},
+            {missing_tab, helpers::FrameError::BadHeader},
+            {bad_crc_field, helpers::FrameError::BadCrcField},
+            {short_crc_field, helpers::FrameError::BadCrcField},
+            {crc_mismatch, helpers::FrameError::CrcMismatch},
+            {etx_before_stx, helpers::FrameError::UnexpectedControl},
+            {eot_in_payload, helpers::FrameError::UnexpectedControl},
+            {truncated, helpers::FrameError::UnexpectedControl},
+            {"\x01" + std::string(300, '1'), helpers::FrameError::Oversize},
+    };
+    for (const auto &[data, expected] : cases) {
+        helpers::FrameParser parser;
+        Collector collector;
+        // the valid frame behind the rejected one is still found, in the same chunk and in the next one
+        EXPECT_EQ(collector.feed(parser, data + frame), 1u) << helpers::to_string(expected);
+        EXPECT_EQ(collector.feed(parser, data), 0u) << helpers::to_string(expected);
+        EXPECT_EQ(collector.feed(parser, frame), 1u) << helpers::to_string(expected);
+        ASSERT_EQ(collector.errors.size(), 2u) << helpers::to_string(expected);
+        EXPECT_EQ(collector.errors[0], expected);
+        EXPECT_EQ(collector.errors[1], expected);
+        EXPECT_EQ(parser.error_count(expected), 2u) << helpers::to_string(expected);
+        EXPECT_EQ(parser.total_error_count(), 2u) << helpers::to_string(expected);
+        EXPECT_EQ(parser.valid_count(), 2u) << helpers::to_string(expected);
+        ASSERT_EQ(collector.frames.size(), 2u);
+        EXPECT_EQ(collector.frames[1].payload, padded(feedback));
+        EXPECT_EQ(collector.frames[1].nsec, 5u);
+    }
+}
+
+TEST(FrameParser, ReassemblesFrameSplitAtEveryByte){
+    auto frame = make_frame(feedback, 12, 34);
+    for (std::size_t split = 0; split <= frame.size(); split++) {
+        helpers::FrameParser parser;
+        Collector collector;
+        EXPECT_EQ(collector.feed(parser, frame.substr(0, split)), split == frame.size() ? 1u : 0u);
+        EXPECT_EQ(collector.feed(parser, frame.substr(split)), split == frame.size() ? 0u : 1u);
+        ASSERT_EQ(collector.frames.size(), 1u) << "split at " << split;
+        EXPECT_EQ(collector.frames[0].payload, padded(feedback)) << "split at " << split;
+        EXPECT_EQ(collector.frames[0].sec, 12u);
+        EXPECT_EQ(collector.frames[0].nsec, 34u);
+        EXPECT_TRUE(collector.errors.empty());
+    }
+
+    // one byte per read, with a rejected frame in between
+    auto corrupted = frame;
+    corrupted[frame.find('\x02') + 1] = '9';
+    auto stream = "noise" + frame + corrupted + frame;
+    helpers::FrameParser parser;
+    Collector collector;
+    for (char c : stream) {
+        collector.feed(parser, std::string(1, c));
+    }
+    EXPECT_EQ(collector.frames.size(), 2u);
+    ASSERT_EQ(collector.errors.size(), 1u);
+    EXPECT_EQ(collector.errors[0], helpers::FrameError::CrcMismatch);
+}
+
+TEST(FrameParser, RejectsOversizeFrames){
+    helpers::FrameParser parser(64);
+    Collector collector;
+    auto fits = make_frame(std::string(32, '5'));
+    auto too_long = make_frame(std::string(64, '5'));
+    ASSERT_LE(fits.size(), 64u);
+    EXPECT_EQ(collector.feed(parser, fits), 1u);
+    // the size limit holds across chunks as well, the carry buffer never grows past it
+    EXPECT_EQ(collector.feed(parser, too_long.substr(0, 40)), 0u);
+    EXPECT_EQ(collector.feed(parser, too_long.substr(40)), 0u);
+    EXPECT_EQ(parser.error_count(helpers::FrameError::Oversize), 1u);
+    // the bytes after the limit are skipped until the next SOH
+    EXPECT_EQ(collector.feed(parser, too_long + fits), 1u);
+    EXPECT_EQ(parser.error_count(helpers::FrameError::Oversize), 2u);
+    EXPECT_EQ(parser.total_error_count(), 2u);
+    EXPECT_EQ(parser.valid_count(), 2u);
+}
+
+TEST(FrameParser, ResetDropsPartialFrame){
+    helpers::FrameParser parser;
+    Collector collector;
+    auto frame = make_frame(feedback);
+    collector.feed(parser, frame.substr(0, 20));
+    parser.reset();
+    // without the head the tail is skipped like garbage
+    EXPECT_EQ(collector.feed(parser, frame.substr(20)), 0u);
+    EXPECT_EQ(collector.feed(parser, frame), 1u);
+    EXPECT_TRUE(collector.errors.empty());
+}
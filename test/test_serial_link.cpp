@@ -0,0 +1,199 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include "rclcpp/rclcpp.hpp"
+#include "ros2_uart_agent/binary_protocol.hpp"
+#include "ros2_uart_agent/event_loop.hpp"
+#include "ros2_uart_agent/serial_link.hpp"
+
+namespace {
+    // the slave end is the link's device, the master plays the microcontroller
+    struct PtyPair{
+        PtyPair(){
+            master = posix_openpt(O_RDWR | O_NOCTTY | O_CLOEXEC);
+            if (master >= 0 && grantpt(master) == 0 && unlockpt(master) == 0) {
+                slave_path = ptsname(master);
+            }
+        }
+
+        ~PtyPair(){
+            close_master();
+        }
+
+        // hangs up the slave, like unplugging a USB adapter
+        void close_master(){
+            if (master >= 0) {
+                ::close(master);
+                master = -1;
+            }
+        }
+
+        int master = -1;
+        std::string slave_path;
+    };
+
+    bool wait_readable(int fd){
+        pollfd pfd{fd, POLLIN, 0};
+        return poll(&pfd, 1, 2000) == 1;
+    }
+
+    // the rx status the link appends to the diagnostics array
+    diagnostic_msgs::msg::DiagnosticStatus rx_status(ros2_uart_agent::SerialLink &link){
+        diagnostic_msgs::msg::DiagnosticArray array;
+        link.append_diagnostics(array, "test_serial_link");
+        for (const auto &status : array.status) {
+            if (status.name == "test_serial_link: " + link.config().name + " rx") {
+                return status;
+            }
+        }
+        ADD_FAILURE() << "no rx status";
+        return diagnostic_msgs::msg::DiagnosticStatus();
+    }
+
+    std::string value(const diagnostic_msgs::msg::DiagnosticStatus &status, const std::string &key){
+        for (const auto &key_value : status.values) {
+            if (key_value.key == key) {
+                return key_value.value;
+            }
+        }
+        return "";
+    }
+
+    template<typename Predicate>
+    bool wait_until(Predicate predicate, std::chrono::milliseconds timeout = std::chrono::milliseconds(2000)){
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (!predicate()) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    class SerialLinkTest : public ::testing::Test{
+    protected:
+        static void SetUpTestSuite(){
+            rclcpp::init(0, nullptr);
+        }
+
+        static void TearDownTestSuite(){
+            rclcpp::shutdown();
+        }
+
+        std::unique_ptr<ros2_uart_agent::SerialLink> make_link(const PtyPair &pty, const std::string &name,
+                                                               helpers::Protocol protocol = helpers::Protocol::Ascii){
+            ros2_uart_agent::LinkConfig config;
+            config.name = name;
+            config.protocol = protocol;
+            config.device = pty.slave_path;
+            config.control_topic = "/" + name + "/control";
+            config.joint_states_topic = "/" + name + "/joint_states";
+            config.joint_names = helpers::default_joint_names();
+            return std::make_unique<ros2_uart_agent::SerialLink>(*node_, config, false);
+        }
+
+        std::shared_ptr<rclcpp::Node> node_ = std::make_shared<rclcpp::Node>("test_serial_link");
+    };
+}
+
+TEST_F(SerialLinkTest, HungUpLinkIsRemovedFromEventLoop){
+    PtyPair hung_up_pty;
+    PtyPair healthy_pty;
+    std::array<std::unique_ptr<ros2_uart_agent::SerialLink>, 2> links{make_link(hung_up_pty, "hung_up"),
+                                                                       make_link(healthy_pty, "healthy")};
+    helpers::EventLoop event_loop;
+    for (std::size_t i = 0; i < links.size(); i++) {
+        ASSERT_GE(links[i]->fd(), 0);
+        ASSERT_TRUE(event_loop.add(links[i]->fd(), i));
+    }
+
+    // dispatches the way UartAgentNode::read_serial does
+    std::array<std::atomic<int>, 2> events{};
+    std::array<std::atomic<bool>, 2> removed{};
+    std::thread rx_thread([&](){
+        event_loop.run([&](std::size_t id, bool hung_up){
+            events[id]++;
+            if (!links[id]->on_readable(hung_up)) {
+                event_loop.remove(links[id]->fd());
+                removed[id] = true;
+            }
+        });
+    });
+
+    hung_up_pty.close_master();
+    EXPECT_TRUE(wait_until([&](){ return removed[0].load(); }));
+    // a spinning loop would have dispatched thousands of events by now
+    std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    EXPECT_EQ(events[0].load(), 1);
+
+    // the remaining link is still served by the same thread
+    ASSERT_EQ(::write(healthy_pty.master, "\x01", 1), 1);
+    EXPECT_TRUE(wait_until([&](){ return events[1].load() > 0; }));
+    EXPECT_FALSE(removed[1].load());
+
+    event_loop.stop();
+    rx_thread.join();
+    EXPECT_EQ(events[0].load(), 1);
+}
+
+TEST_F(SerialLinkTest, ReadableWithoutDataIsTreatedAsHangup){
+    PtyPair pty;
+    auto link = make_link(pty, "link");
+    ASSERT_GE(link->fd(), 0);
+    pty.close_master();
+    EXPECT_FALSE(link->on_readable());
+}
+
+TEST_F(SerialLinkTest, HangupIsReportedAsDiagnosticError){
+    PtyPair pty;
+    auto link = make_link(pty, "link");
+    ASSERT_GE(link->fd(), 0);
+    EXPECT_EQ(rx_status(*link).level, diagnostic_msgs::msg::DiagnosticStatus::OK);
+
+    pty.close_master();
+    EXPECT_FALSE(link->on_readable(true));
+    auto status = rx_status(*link);
+    EXPECT_EQ(status.level, diagnostic_msgs::msg::DiagnosticStatus::ERROR);
+    EXPECT_EQ(status.message, "device hung up");
+    // the link stays in error, a later read failure does not replace the reason
+    link->set_rx_error("rx thread stopped");
+    status = rx_status(*link);
+    EXPECT_EQ(status.level, diagnostic_msgs::msg::DiagnosticStatus::ERROR);
+    EXPECT_EQ(status.message, "device hung up");
+}
+
+TEST_F(SerialLinkTest, BinaryFeedbackWithWrongJointCountIsRejected){
+    PtyPair pty;
+    auto link = make_link(pty, "link", helpers::Protocol::Binary);
+    ASSERT_GE(link->fd(), 0);
+    std::string data;
+    // a well formed frame with one value too many, then a good one
+    for (auto count : {helpers::num_joints + 1, helpers::num_joints}) {
+        std::vector<std::uint16_t> adc_values(count, 2011);
+        std::array<char, helpers::binary::max_encoded_size> buffer{};
+        data.append(buffer.data(), helpers::encode_binary_feedback(buffer.data(), adc_values.data(), count, 1, 2));
+    }
+    ASSERT_EQ(::write(pty.master, data.data(), data.size()), static_cast<ssize_t>(data.size()));
+    ASSERT_TRUE(wait_readable(link->fd()));
+    EXPECT_TRUE(link->on_readable());
+
+    auto status = rx_status(*link);
+    EXPECT_EQ(status.level, diagnostic_msgs::msg::DiagnosticStatus::OK);
+    if constexpr (helpers::metrics_enabled) {
+        EXPECT_EQ(value(status, "frames"), "2");
+        EXPECT_EQ(value(status, "decode_errors"), "1");
+        EXPECT_EQ(value(status, "crc_failures"), "0");
+        EXPECT_EQ(value(status, "framing_errors"), "0");
+    }
+}
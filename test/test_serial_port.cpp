@@ -0,0 +1,263 @@
+#include <gtest/gtest.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <poll.h>
+#include <termios.h>
+#include <unistd.h>
+
+#include "ros2_uart_agent/serial_port.hpp"
+
+namespace {
+    // both ends of a Linux pty, the slave plays the UART device and the master the microcontroller
+    struct PtyPair{
+        PtyPair(){
+            master = posix_openpt(O_RDWR | O_NOCTTY | O_CLOEXEC);
+            if (master >= 0 && grantpt(master) == 0 && unlockpt(master) == 0) {
+                slave_path = ptsname(master);
+            }
+        }
+
+        ~PtyPair(){
+            close_master();
+        }
+
+        // hangs up the slave, like unplugging a USB adapter
+        void close_master(){
+            if (master >= 0) {
+                ::close(master);
+                master = -1;
+            }
+        }
+
+        // reads exactly size bytes from the master, waiting at most timeout for each chunk
+        std::string read_master(std::size_t size, std::chrono::milliseconds timeout = std::chrono::milliseconds(2000)) const {
+            std::string data;
+            std::vector<char> chunk(4096);
+            while (data.size() < size) {
+                pollfd pfd{master, POLLIN, 0};
+                if (poll(&pfd, 1, static_cast<int>(timeout.count())) <= 0) {
+                    break;
+                }
+                auto count = ::read(master, chunk.data(), std::min(chunk.size(), size - data.size()));
+                if (count <= 0) {
+                    break;
+                }
+                data.append(chunk.data(), static_cast<std::size_t>(count));
+            }
+            return data;
+        }
+
+        void write_master(const std::string &data) const {
+            ASSERT_EQ(::write(master, data.data(), data.size()), static_cast<ssize_t>(data.size()));
+        }
+
+        int master = -1;
+        std::string slave_path;
+    };
+
+    // reads from the port until size bytes arrived or a read returns nothing
+    std::string read_port(helpers::SerialPort &port, std::size_t size){
+        std::string data;
+        char chunk[64];
+        while (data.size() < size) {
+            auto count = port.read_some(chunk, sizeof(chunk), 500);
+            if (count <= 0) {
+                break;
+            }
+            data.append(chunk, static_cast<std::size_t>(count));
+        }
+        return data;
+    }
+
+    std::string pattern(std::size_t size){
+        std::string data(size, '\0');
+        for (std::size_t i = 0; i < size; i++) {
+            data[i] = static_cast<char>('a' + (i * 7 + i / 251) % 26);
+        }
+        return data;
+    }
+}
+
+TEST(SerialPort, AttachAppliesRawNonBlockingSetup){
+    PtyPair pty;
+    ASSERT_FALSE(pty.slave_path.empty());
+    int fd = ::open(pty.slave_path.c_str(), O_RDWR | O_NOCTTY);
+    ASSERT_GE(fd, 0);
+
+    helpers::SerialPort port;
+    ASSERT_TRUE(port.attach(fd, 115200));
+    EXPECT_TRUE(port.is_open());
+    EXPECT_EQ(port.fd(), fd);
+    EXPECT_TRUE(fcntl(fd, F_GETFL) & O_NONBLOCK);
+
+    termios options{};
+    ASSERT_EQ(tcgetattr(fd, &options), 0);
+    EXPECT_EQ(options.c_lflag & (ICANON | ECHO | ISIG), 0u);
+    EXPECT_EQ(options.c_iflag & (ICRNL | IXON), 0u);
+    EXPECT_EQ(options.c_oflag & OPOST, 0u);
+    EXPECT_EQ(options.c_cflag & CSIZE, static_cast<tcflag_t>(CS8));
+    EXPECT_EQ(options.c_cflag & (PARENB | CSTOPB), 0u);
+    EXPECT_EQ(options.c_cc[VMIN], 0);
+    EXPECT_EQ(options.c_cc[VTIME], 0);
+    EXPECT_EQ(cfgetospeed(&options), static_cast<speed_t>(B115200));
+
+    // raw mode passes control characters through untouched
+    std::string binary("\x01\x02\r\n\x03\x04\x00\x7f", 8);
+    pty.write_master(binary);
+    EXPECT_EQ(read_port(port, binary.size()), binary);
+
+    port.close();
+    EXPECT_FALSE(port.is_open());
+    EXPECT_EQ(port.read_some(nullptr, 0), -1);
+}
+
+TEST(SerialPort, RejectsUnsupportedBaud){
+    PtyPair pty;
+    helpers::SerialPort port;
+    EXPECT_FALSE(port.open(pty.slave_path, 12345));
+    EXPECT_FALSE(port.is_open());
+}
+
+TEST(SerialPort, ReadsDataArrivingInChunks){
+    PtyPair pty;
+    helpers::SerialPort port;
+    ASSERT_TRUE(port.open(pty.slave_path, 1000000));
+
+    char buffer[256];
+    EXPECT_EQ(port.read_some(buffer, sizeof(buffer), 0), 0);
+    EXPECT_EQ(port.read_available(buffer, sizeof(buffer)), 0);
+
+    // the writer trickles a frame in pieces while the reader blocks in between
+    const std::vector<std::string> pieces{"\x01" "12", "34\x02", "0890\t2011", "\t3020\n\x03", "crc\x04"};
+    std::string expected;
+    for (const auto &piece : pieces) {
+        expected += piece;
+    }
+    auto writer = std::thread([&pty, &pieces](){
+        for (const auto &piece : pieces) {
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+            pty.write_master(piece);
+        }
+    });
+    std::string received;
+    int reads = 0;
+    while (received.size() < expected.size()) {
+        auto count = port.read_some(buffer, sizeof(buffer), 1000);
+        ASSERT_GT(count, 0);
+        received.append(buffer, static_cast<std::size_t>(count));
+        reads++;
+    }
+    writer.join();
+    EXPECT_EQ(received, expected);
+    EXPECT_GT(reads, 1);
+
+    // a chunk larger than the caller's buffer is drained over several reads without losing bytes
+    auto large = pattern(1000);
+    pty.write_master(large);
+    EXPECT_EQ(read_port(port, large.size()), large);
+}
+
+TEST(SerialPort, WriteAllCompletesPartialWrites){
+    PtyPair pty;
+    helpers::SerialPort port;
+    ASSERT_TRUE(port.open(pty.slave_path, 1000000));
+
+    // far more than the pty buffer holds, so write() returns short counts and EAGAIN
+    auto data = pattern(256 * 1024);
+    auto reader = std::async(std::launch::async, [&pty, &data](){ return pty.read_master(data.size()); });
+    EXPECT_EQ(port.write_all(data.data(), data.size()), static_cast<ssize_t>(data.size()));
+    EXPECT_EQ(reader.get(), data);
+}
+
+TEST(SerialPort, WritevAllCompletesPartialWrites){
+    PtyPair pty;
+    helpers::SerialPort port;
+    ASSERT_TRUE(port.open(pty.slave_path, 1000000));
+
+    // uneven buffers, so short writes end in the middle of one and the rest has to be trimmed
+    std::vector<std::string> frames;
+    std::vector<iovec> buffers;
+    std::string expected;
+    for (int i = 0; i < helpers::SerialPort::max_iovecs; i++) {
+        frames.push_back(pattern(1000 + i * 4099));
+        expected += frames.back();
+    }
+    for (auto &frame : frames) {
+        buffers.push_back({frame.data(), frame.size()});
+    }
+    auto reader = std::async(std::launch::async, [&pty, &expected](){ return pty.read_master(expected.size()); });
+    EXPECT_EQ(port.writev_all(buffers.data(), static_cast<int>(buffers.size())), static_cast<ssize_t>(expected.size()));
+    EXPECT_EQ(reader.get(), expected);
+
+    EXPECT_EQ(port.writev_all(buffers.data(), helpers::SerialPort::max_iovecs + 1), -1);
+}
+
+TEST(SerialPort, InterruptWakesBlockedRead){
+    PtyPair pty;
+    helpers::SerialPort port;
+    ASSERT_TRUE(port.open(pty.slave_path, 1000000));
+
+    auto reader = std::async(std::launch::async, [&port](){
+        char buffer[64];
+        return port.read_some(buffer, sizeof(buffer));
+    });
+    EXPECT_EQ(reader.wait_for(std::chrono::milliseconds(50)), std::future_status::timeout);
+    port.interrupt();
+    ASSERT_EQ(reader.wait_for(std::chrono::seconds(2)), std::future_status::ready);
+    EXPECT_EQ(reader.get(), 0);
+
+    // the wake-up was consumed, data still flows afterwards
+    pty.write_master("ok");
+    EXPECT_EQ(read_port(port, 2), "ok");
+}
+
+TEST(SerialPort, InterruptBeforeReadIsNotLost){
+    PtyPair pty;
+    helpers::SerialPort port;
+    ASSERT_TRUE(port.open(pty.slave_path, 1000000));
+    port.interrupt();
+    char buffer[64];
+    EXPECT_EQ(port.read_some(buffer, sizeof(buffer), 2000), 0);
+}
+
+TEST(SerialPort, CancelWritesUnblocksWriterOnUndrainedLine){
+    PtyPair pty;
+    helpers::SerialPort port;
+    ASSERT_TRUE(port.open(pty.slave_path, 1000000));
+
+    // nobody reads the master, the write blocks once the pty buffer is full
+    auto data = pattern(1024 * 1024);
+    auto writer = std::async(std::launch::async, [&port, &data](){ return port.write_all(data.data(), data.size()); });
+    EXPECT_EQ(writer.wait_for(std::chrono::milliseconds(100)), std::future_status::timeout);
+    port.cancel_writes();
+    ASSERT_EQ(writer.wait_for(std::chrono::seconds(2)), std::future_status::ready);
+    EXPECT_EQ(writer.get(), -1);
+}
+
+TEST(SerialPort, HangupReportsError){
+    PtyPair pty;
+    helpers::SerialPort port;
+    ASSERT_TRUE(port.open(pty.slave_path, 1000000));
+    char buffer[64];
+    EXPECT_EQ(port.read_available(buffer, sizeof(buffer)), 0);
+    pty.close_master();
+
+    // every call fails straight away instead of returning 0 like a timeout, so a read loop cannot spin
+    auto start = std::chrono::steady_clock::now();
+    for (int i = 0; i < 3; i++) {
+        errno = 0;
+        EXPECT_EQ(port.read_some(buffer, sizeof(buffer), 1000), -1);
+        EXPECT_EQ(errno, EIO);
+        errno = 0;
+        EXPECT_EQ(port.read_available(buffer, sizeof(buffer)), -1);
+        EXPECT_EQ(errno, EIO);
+    }
+    EXPECT_LT(std::chrono::steady_clock::now() - start, std::chrono::milliseconds(500));
+}
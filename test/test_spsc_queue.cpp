@@ -0,0 +1,170 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <future>
+#include <thread>
+
+#include "ros2_uart_agent/spsc_queue.hpp"
+
+namespace {
+    // several words per slot, so a slot read while it is being written shows up as a mismatch
+    struct Slot{
+        std::uint64_t sequence = 0;
+        std::array<std::uint64_t, 7> check{};
+
+        void fill(std::uint64_t value){
+            sequence = value;
+            for (std::size_t i = 0; i < check.size(); i++) {
+                check[i] = value * 2654435761u + i;
+            }
+        }
+
+        bool intact() const{
+            for (std::size_t i = 0; i < check.size(); i++) {
+                if (check[i] != sequence * 2654435761u + i) {
+                    return false;
+                }
+            }
+            return true;
+        }
+    };
+
+    template<typename Queue>
+    bool push(Queue &queue, std::uint64_t value){
+        auto slot = queue.acquire();
+        if (slot == nullptr) {
+            return false;
+        }
+        slot->fill(value);
+        queue.commit();
+        return true;
+    }
+}
+
+TEST(SpscQueue, OverflowDropsNewFramesWithoutTouchingQueuedOnes){
+    helpers::SpscQueue<Slot, 4> queue;
+    EXPECT_EQ(queue.front(), nullptr);
+    for (std::uint64_t i = 0; i < 4; i++) {
+        ASSERT_TRUE(push(queue, i));
+    }
+    EXPECT_EQ(queue.size(), 4u);
+    EXPECT_FALSE(push(queue, 100));
+    EXPECT_FALSE(push(queue, 101));
+    queue.record_drop();
+    EXPECT_EQ(queue.overflow_count(), 2u);
+    EXPECT_EQ(queue.dropped_count(), 3u);
+    EXPECT_EQ(queue.pushed_count(), 4u);
+
+    for (std::uint64_t i = 0; i < 4; i++) {
+        auto slot = queue.front();
+        ASSERT_NE(slot, nullptr);
+        EXPECT_EQ(slot->sequence, i);
+        EXPECT_TRUE(slot->intact());
+        queue.pop();
+    }
+    EXPECT_EQ(queue.front(), nullptr);
+    // the ring is usable again after it was full, across the wrap around
+    for (std::uint64_t i = 4; i < 10; i++) {
+        ASSERT_TRUE(push(queue, i));
+        auto slot = queue.front();
+        ASSERT_NE(slot, nullptr);
+        EXPECT_EQ(slot->sequence, i);
+        queue.pop();
+    }
+    EXPECT_EQ(queue.overflow_count(), 2u);
+}
+
+TEST(SpscQueue, CloseWakesBlockedConsumer){
+    helpers::SpscQueue<Slot, 4> queue;
+    auto consumer = std::async(std::launch::async, [&queue](){ return queue.wait_front(); });
+    EXPECT_EQ(consumer.wait_for(std::chrono::milliseconds(50)), std::future_status::timeout);
+    queue.close();
+    ASSERT_EQ(consumer.wait_for(std::chrono::seconds(2)), std::future_status::ready);
+    EXPECT_EQ(consumer.get(), nullptr);
+}
+
+TEST(SpscQueue, CloseDrainsQueuedSlotsFirst){
+    helpers::SpscQueue<Slot, 4> queue;
+    ASSERT_TRUE(push(queue, 1));
+    ASSERT_TRUE(push(queue, 2));
+    queue.close();
+    for (std::uint64_t i = 1; i <= 2; i++) {
+        auto slot = queue.wait_front();
+        ASSERT_NE(slot, nullptr);
+        EXPECT_EQ(slot->sequence, i);
+        queue.pop();
+    }
+    EXPECT_EQ(queue.wait_front(), nullptr);
+}
+
+TEST(SpscQueue, CommitWakesBlockedConsumer){
+    helpers::SpscQueue<Slot, 4> queue;
+    auto consumer = std::async(std::launch::async, [&queue](){
+        auto slot = queue.wait_front();
+        return slot == nullptr ? UINT64_MAX : slot->sequence;
+    });
+    EXPECT_EQ(consumer.wait_for(std::chrono::milliseconds(50)), std::future_status::timeout);
+    ASSERT_TRUE(push(queue, 7));
+    ASSERT_EQ(consumer.wait_for(std::chrono::seconds(2)), std::future_status::ready);
+    EXPECT_EQ(consumer.get(), 7u);
+}
+
+TEST(SpscQueue, StressKeepsOrderAndLosesNothingUnderCapacity){
+    constexpr std::uint64_t total = 1000000;
+    helpers::SpscQueue<Slot, 8> queue;
+    // the producer never outruns the ring, so every frame has to arrive, in order and intact
+    std::thread producer([&queue](){
+        for (std::uint64_t i = 0; i < total; i++) {
+            while (queue.size() == queue.capacity()) {
+                std::this_thread::yield();
+            }
+            push(queue, i);
+        }
+        queue.close();
+    });
+    std::uint64_t expected = 0;
+    std::uint64_t torn = 0;
+    while (auto slot = queue.wait_front()) {
+        if (slot->sequence != expected || !slot->intact()) {
+            torn++;
+        }
+        expected = slot->sequence + 1;
+        queue.pop();
+    }
+    producer.join();
+    EXPECT_EQ(expected, total);
+    EXPECT_EQ(torn, 0u);
+    EXPECT_EQ(queue.pushed_count(), total);
+    EXPECT_EQ(queue.overflow_count(), 0u);
+    EXPECT_EQ(queue.dropped_count(), 0u);
+}
+
+TEST(SpscQueue, StressAccountsForEveryDroppedFrame){
+    constexpr std::uint64_t total = 1000000;
+    helpers::SpscQueue<Slot, 8> queue;
+    // the producer does not wait, whatever does not fit is dropped and counted
+    std::thread producer([&queue](){
+        for (std::uint64_t i = 0; i < total; i++) {
+            push(queue, i);
+        }
+        queue.close();
+    });
+    std::uint64_t received = 0;
+    std::uint64_t out_of_order = 0;
+    std::uint64_t next = 0;
+    while (auto slot = queue.wait_front()) {
+        if (slot->sequence < next || !slot->intact()) {
+            out_of_order++;
+        }
+        next = slot->sequence + 1;
+        received++;
+        queue.pop();
+    }
+    producer.join();
+    EXPECT_EQ(out_of_order, 0u);
+    EXPECT_EQ(received, queue.pushed_count());
+    EXPECT_EQ(received + queue.dropped_count(), total);
+    EXPECT_EQ(queue.overflow_count(), queue.dropped_count());
+}
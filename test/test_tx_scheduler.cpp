@@ -0,0 +1,208 @@
+#include <gtest/gtest.h>
+
+#include <cerrno>
+#include <chrono>
+#include <cstdlib>
+#include <string>
+#include <thread>
+#include <vector>
+#include <fcntl.h>
+#include <poll.h>
+#include <unistd.h>
+
+#include "ros2_uart_agent/metrics.hpp"
+#include "ros2_uart_agent/serial_port.hpp"
+#include "ros2_uart_agent/tx_scheduler.hpp"
+
+namespace {
+    // the slave end is the UART, nobody reads the master until a test drains it
+    struct PtyPair{
+        PtyPair(){
+            master = posix_openpt(O_RDWR | O_NOCTTY | O_CLOEXEC);
+            if (master >= 0 && grantpt(master) == 0 && unlockpt(master) == 0) {
+                slave_path = ptsname(master);
+            }
+        }
+
+        ~PtyPair(){
+            if (master >= 0) {
+                ::close(master);
+            }
+        }
+
+        // reads exactly size bytes from the master, waiting at most timeout for each chunk
+        std::string read_master(std::size_t size, std::chrono::milliseconds timeout = std::chrono::milliseconds(2000)) const {
+            std::string data;
+            std::vector<char> chunk(4096);
+            while (data.size() < size) {
+                pollfd pfd{master, POLLIN, 0};
+                if (poll(&pfd, 1, static_cast<int>(timeout.count())) <= 0) {
+                    break;
+                }
+                auto count = ::read(master, chunk.data(), std::min(chunk.size(), size - data.size()));
+                if (count <= 0) {
+                    break;
+                }
+                data.append(chunk.data(), static_cast<std::size_t>(count));
+            }
+            return data;
+        }
+
+        int master = -1;
+        std::string slave_path;
+    };
+
+    // writes to the port until the pty stays full, so the next write of the scheduler blocks
+    std::size_t fill(const helpers::SerialPort &port){
+        std::size_t total = 0;
+        std::vector<char> chunk(4096, 'f');
+        // the pty moves data between its buffers in the background, keep going until nothing is accepted
+        for (int idle_rounds = 0; idle_rounds < 3;) {
+            auto count = ::write(port.fd(), chunk.data(), chunk.size());
+            if (count > 0) {
+                total += static_cast<std::size_t>(count);
+                idle_rounds = 0;
+                continue;
+            }
+            EXPECT_EQ(errno, EAGAIN);
+            idle_rounds++;
+            std::this_thread::sleep_for(std::chrono::milliseconds(10));
+        }
+        return total;
+    }
+
+    std::string frame(char tag){
+        return "\x01" + std::string(20, tag) + "\x04";
+    }
+
+    template<typename Predicate>
+    bool wait_until(Predicate predicate, std::chrono::milliseconds timeout = std::chrono::milliseconds(2000)){
+        auto deadline = std::chrono::steady_clock::now() + timeout;
+        while (!predicate()) {
+            if (std::chrono::steady_clock::now() > deadline) {
+                return false;
+            }
+            std::this_thread::sleep_for(std::chrono::milliseconds(1));
+        }
+        return true;
+    }
+
+    class TxSchedulerTest : public ::testing::Test{
+    protected:
+        void SetUp() override {
+            ASSERT_TRUE(port_.open(pty_.slave_path, 1000000));
+        }
+
+        // fills the line and hands the scheduler a first frame, which stays blocked in the write
+        void block_writer(helpers::TxScheduler &scheduler, const std::string &first, std::int64_t received_ns = 0){
+            filled_ = fill(port_);
+            ASSERT_GT(filled_, 0u);
+            ASSERT_TRUE(scheduler.submit(first.data(), first.size(), received_ns));
+            ASSERT_TRUE(wait_until([&](){ return scheduler.stats().queue_depth == 0; }));
+            std::this_thread::sleep_for(std::chrono::milliseconds(50));
+            ASSERT_EQ(scheduler.stats().write_calls, 0u);
+        }
+
+        // drains the master and returns what the scheduler wrote after the filler
+        std::string drain(std::size_t expected){
+            auto data = pty_.read_master(filled_ + expected);
+            EXPECT_EQ(data.size(), filled_ + expected);
+            return data.size() < filled_ ? std::string() : data.substr(filled_);
+        }
+
+        PtyPair pty_;
+        helpers::SerialPort port_;
+        std::size_t filled_ = 0;
+    };
+}
+
+TEST_F(TxSchedulerTest, UnblockedWriteIsNotAStall){
+    helpers::TxScheduler scheduler(port_, helpers::TxScheduler::Options{});
+    scheduler.start();
+    auto data = frame('a');
+    ASSERT_TRUE(scheduler.submit(data.data(), data.size(), helpers::metrics_clock_ns()));
+    EXPECT_EQ(pty_.read_master(data.size()), data);
+    ASSERT_TRUE(wait_until([&](){ return scheduler.stats().written == 1; }));
+    auto stats = scheduler.stats();
+    EXPECT_EQ(stats.write_stall_ns, 0u);
+    EXPECT_EQ(stats.max_write_stall_ns, 0u);
+    EXPECT_EQ(stats.write_errors, 0u);
+    if constexpr (helpers::metrics_enabled) {
+        EXPECT_EQ(scheduler.write_latency().snapshot().count, 1u);
+    }
+    scheduler.stop();
+}
+
+TEST_F(TxSchedulerTest, LatestFrameWinsWhileWriterIsBlocked){
+    helpers::TxScheduler::Options options;
+    options.queue_depth = 4;
+    options.coalesce = true;
+    helpers::TxScheduler scheduler(port_, options);
+    scheduler.start();
+    auto first = frame('0');
+    block_writer(scheduler, first);
+
+    for (char tag : {'1', '2', '3', '4', '5'}) {
+        auto data = frame(tag);
+        ASSERT_TRUE(scheduler.submit(data.data(), data.size()));
+    }
+    auto stats = scheduler.stats();
+    EXPECT_EQ(stats.queue_depth, 1u);
+    EXPECT_EQ(stats.coalesced, 4u);
+    EXPECT_EQ(stats.dropped, 0u);
+
+    // once the line drains, the blocked frame goes out followed by the newest one only
+    EXPECT_EQ(drain(2 * first.size()), first + frame('5'));
+    ASSERT_TRUE(wait_until([&](){ return scheduler.stats().written == 2; }));
+    stats = scheduler.stats();
+    EXPECT_EQ(stats.submitted, 6u);
+    EXPECT_EQ(stats.write_calls, 2u);
+    EXPECT_EQ(stats.write_errors, 0u);
+    EXPECT_GT(stats.write_stall_ns, 0u);
+    EXPECT_EQ(stats.max_write_stall_ns, stats.write_stall_ns);
+    scheduler.stop();
+}
+
+TEST_F(TxSchedulerTest, FullQueueDropsOldestFrames){
+    helpers::TxScheduler::Options options;
+    options.queue_depth = 2;
+    options.coalesce = false;
+    options.batch = true;
+    helpers::TxScheduler scheduler(port_, options);
+    scheduler.start();
+    auto first = frame('0');
+    block_writer(scheduler, first);
+
+    for (char tag : {'1', '2', '3', '4'}) {
+        auto data = frame(tag);
+        ASSERT_TRUE(scheduler.submit(data.data(), data.size()));
+    }
+    // a frame that does not fit into a slot is dropped as well
+    std::string oversize(helpers::TxScheduler::frame_capacity + 1, 'x');
+    EXPECT_FALSE(scheduler.submit(oversize.data(), oversize.size()));
+    auto stats = scheduler.stats();
+    EXPECT_EQ(stats.queue_depth, 2u);
+    EXPECT_EQ(stats.dropped, 3u);
+    EXPECT_EQ(stats.coalesced, 0u);
+
+    EXPECT_EQ(drain(3 * first.size()), first + frame('3') + frame('4'));
+    ASSERT_TRUE(wait_until([&](){ return scheduler.stats().written == 3; }));
+    stats = scheduler.stats();
+    EXPECT_EQ(stats.submitted, 6u);
+    EXPECT_EQ(stats.write_calls, 2u);
+    scheduler.stop();
+}
+
+TEST_F(TxSchedulerTest, FailedWriteIsNotALatencySample){
+    helpers::TxScheduler scheduler(port_, helpers::TxScheduler::Options{});
+    scheduler.start();
+    block_writer(scheduler, frame('0'), helpers::metrics_clock_ns());
+
+    port_.cancel_writes();
+    ASSERT_TRUE(wait_until([&](){ return scheduler.stats().write_errors == 1; }));
+    auto stats = scheduler.stats();
+    EXPECT_EQ(stats.written, 0u);
+    EXPECT_GT(stats.write_stall_ns, 0u);
+    EXPECT_EQ(scheduler.write_latency().snapshot().count, 0u);
+    scheduler.stop();
+}
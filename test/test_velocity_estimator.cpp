@@ -0,0 +1,145 @@
+#include <gtest/gtest.h>
+
+#include <array>
+#include <cstdint>
+#include <random>
+
+#include "ros2_uart_agent/velocity_estimator.hpp"
+
+namespace {
+    using Estimator = helpers::VelocityEstimator<3, 8>;
+    using Positions = std::array<double, 3>;
+
+    const Positions velocity{1.5, -0.25, 0.0};
+    const Positions offset{0.3, -1.0, 2.0};
+
+    // joint angles moving at a constant velocity since start_ns
+    Positions ramp(std::int64_t stamp_ns, std::int64_t start_ns = 0){
+        Positions positions;
+        for (std::size_t i = 0; i < positions.size(); i++) {
+            positions[i] = offset[i] + velocity[i] * static_cast<double>(stamp_ns - start_ns) * 1e-9;
+        }
+        return positions;
+    }
+
+    Estimator::Options options(helpers::VelocityFilter filter){
+        Estimator::Options options;
+        options.filter = filter;
+        return options;
+    }
+
+    void expect_velocity(const Positions &estimate, const Positions &expected, double tolerance, const char *context){
+        for (std::size_t i = 0; i < estimate.size(); i++) {
+            EXPECT_NEAR(estimate[i], expected[i], tolerance) << context << ", joint " << i;
+        }
+    }
+
+    class VelocityEstimatorTest : public ::testing::TestWithParam<helpers::VelocityFilter>{};
+}
+
+TEST_P(VelocityEstimatorTest, RampGivesSlopeAfterWarmup){
+    Estimator estimator(options(GetParam()));
+    // about 100 Hz with jitter, starting far from zero like a wall clock stamp
+    std::mt19937 rng(1);
+    std::uniform_int_distribution<std::int64_t> period(8000000, 12000000);
+    const std::int64_t start_ns = 1575000000LL * 1000000000LL;
+    auto stamp_ns = start_ns;
+    expect_velocity(estimator.update(ramp(stamp_ns, start_ns), stamp_ns), {}, 0.0, "first sample");
+    // the windowed filters are exact once they have two samples, alpha-beta converges
+    auto warmup = GetParam() == helpers::VelocityFilter::AlphaBeta ? 3000 : 1;
+    for (int i = 0; i < warmup + 500; i++) {
+        stamp_ns += period(rng);
+        auto estimate = estimator.update(ramp(stamp_ns, start_ns), stamp_ns);
+        if (i >= warmup) {
+            expect_velocity(estimate, velocity, 1e-6, "ramp");
+        }
+    }
+}
+
+TEST_P(VelocityEstimatorTest, GapLongerThanMaxGapRestarts){
+    auto gap_options = options(GetParam());
+    gap_options.max_gap_ns = 50000000;
+    Estimator estimator(gap_options);
+    std::int64_t stamp_ns = 0;
+    for (int i = 0; i < 100; i++) {
+        stamp_ns += 10000000;
+        estimator.update(ramp(stamp_ns), stamp_ns);
+    }
+    stamp_ns += 200000000;
+    expect_velocity(estimator.update(ramp(stamp_ns), stamp_ns), {}, 0.0, "after the gap");
+    if (GetParam() != helpers::VelocityFilter::AlphaBeta) {
+        stamp_ns += 10000000;
+        expect_velocity(estimator.update(ramp(stamp_ns), stamp_ns), velocity, 1e-9, "after the restart");
+    }
+    // a gap within the limit does not restart
+    stamp_ns += 40000000;
+    EXPECT_NE(estimator.update(ramp(stamp_ns), stamp_ns)[0], 0.0);
+}
+
+TEST_P(VelocityEstimatorTest, GapResetIsDisabledByDefault){
+    Estimator estimator(options(GetParam()));
+    EXPECT_EQ(estimator.options().max_gap_ns, 0);
+    // 1 Hz feedback keeps producing velocities
+    std::int64_t stamp_ns = 0;
+    Positions estimate{};
+    for (int i = 0; i < 20; i++) {
+        stamp_ns += 1000000000;
+        estimate = estimator.update(ramp(stamp_ns), stamp_ns);
+    }
+    EXPECT_NE(estimate[0], 0.0);
+    if (GetParam() != helpers::VelocityFilter::AlphaBeta) {
+        expect_velocity(estimate, velocity, 1e-9, "1 Hz");
+    }
+}
+
+TEST_P(VelocityEstimatorTest, IgnoresNonMonotonicStamp){
+    Estimator estimator(options(GetParam()));
+    std::int64_t stamp_ns = 0;
+    for (int i = 0; i < 5000; i++) {
+        stamp_ns += 10000000;
+        estimator.update(ramp(stamp_ns), stamp_ns);
+    }
+    auto before = estimator.update(ramp(stamp_ns + 10000000), stamp_ns + 10000000);
+    stamp_ns += 10000000;
+    // a repeated and an older stamp with positions far off the ramp change nothing
+    Positions outlier{100.0, 100.0, 100.0};
+    EXPECT_EQ(estimator.update(outlier, stamp_ns), before);
+    EXPECT_EQ(estimator.update(outlier, stamp_ns - 30000000), before);
+    stamp_ns += 10000000;
+    expect_velocity(estimator.update(ramp(stamp_ns), stamp_ns), velocity, 1e-6, "after the reordered samples");
+}
+
+TEST_P(VelocityEstimatorTest, RestartsWhenTheClockStartsOver){
+    Estimator estimator(options(GetParam()));
+    std::int64_t stamp_ns = 1000000000000;
+    for (int i = 0; i < 100; i++) {
+        stamp_ns += 10000000;
+        estimator.update(ramp(stamp_ns, 1000000000000), stamp_ns);
+    }
+    // the microcontroller rebooted, its stamps now stay below the last one for good
+    stamp_ns = 0;
+    Positions estimate{};
+    for (std::size_t i = 0; i < Estimator::window() + 5000; i++) {
+        stamp_ns += 10000000;
+        estimate = estimator.update(ramp(stamp_ns), stamp_ns);
+    }
+    expect_velocity(estimate, velocity, 1e-6, "new clock");
+}
+
+INSTANTIATE_TEST_SUITE_P(AllFilters, VelocityEstimatorTest,
+                         ::testing::Values(helpers::VelocityFilter::MovingAverage, helpers::VelocityFilter::SavitzkyGolay,
+                                           helpers::VelocityFilter::AlphaBeta),
+                         [](const ::testing::TestParamInfo<helpers::VelocityFilter> &info){
+                             switch (info.param) {
+                                 case helpers::VelocityFilter::SavitzkyGolay: return "SavitzkyGolay";
+                                 case helpers::VelocityFilter::AlphaBeta: return "AlphaBeta";
+                                 default: return "MovingAverage";
+                             }
+                         });
+
+TEST(VelocityEstimator, ParsesFilterNames){
+    EXPECT_EQ(helpers::velocity_filter_from_string("moving_average"), helpers::VelocityFilter::MovingAverage);
+    EXPECT_EQ(helpers::velocity_filter_from_string("savitzky_golay"), helpers::VelocityFilter::SavitzkyGolay);
+    EXPECT_EQ(helpers::velocity_filter_from_string("alpha_beta"), helpers::VelocityFilter::AlphaBeta);
+    EXPECT_FALSE(helpers::velocity_filter_from_string("kalman").has_value());
+}
@@ -0,0 +1,204 @@
+/*
+ * Command to feedback latency and throughput harness for the agent.
+ *
+ *   mcu_simulator --link /tmp/ttyMCU --rate 0 &
+ *   ros2 run ros2_uart_agent raspi_pub --ros-args -p device:=/tmp/ttyMCU &
+ *   ros2 run ros2_uart_agent latency_harness --ros-args -p rates:="[100, 500, 1000, 2000]"
+ *
+ * JointControl commands are published at each rate in turn, every one with a unique header stamp.
+ * The microcontroller (or mcu_simulator) echoes the stamp of the last command in its feedback and
+ * the agent publishes it in the JointState header, so a JointState whose stamp matches a command
+ * closes that command's round trip. Commands that never come back were coalesced by the agent,
+ * dropped or corrupted on the line. The highest rate that loses at most max_loss of its commands
+ * with a p99 under p99_limit_ms is reported as the maximum sustainable rate.
+ */
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "rclcpp/rclcpp.hpp"
+#include "sensor_msgs/msg/joint_state.hpp"
+#include "ros2_control_interfaces/msg/joint_control.hpp"
+#include "ros2_uart_agent/adc_decoder.hpp"
+
+namespace{
+    using ros2_control_interfaces::msg::JointControl;
+    using sensor_msgs::msg::JointState;
+
+    std::int64_t steady_ns(){
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    std::int64_t stamp_ns(std::int32_t sec, std::uint32_t nsec){
+        return static_cast<std::int64_t>(sec) * 1000000000 + nsec;
+    }
+
+    struct StepResult{
+        double rate_hz = 0;
+        std::size_t sent = 0;
+        std::size_t matched = 0;
+        std::size_t feedback = 0;
+        double duration_s = 0;
+        std::vector<std::int64_t> rtt_ns;
+
+        double loss() const {
+            return sent == 0 ? 0 : 1.0 - static_cast<double>(matched) / static_cast<double>(sent);
+        }
+
+        double percentile_ms(double p) const {
+            if (rtt_ns.empty()) {
+                return NAN;
+            }
+            auto index = static_cast<std::size_t>(std::ceil(p / 100.0 * static_cast<double>(rtt_ns.size())));
+            return static_cast<double>(rtt_ns[std::min(std::max<std::size_t>(index, 1), rtt_ns.size()) - 1]) * 1e-6;
+        }
+    };
+
+    class LatencyHarness : public rclcpp::Node{
+    public:
+        LatencyHarness() : Node("latency_harness") {
+            rates_ = this->declare_parameter<std::vector<int64_t>>("rates", {50, 100, 200, 500, 1000, 2000});
+            step_duration_s_ = this->declare_parameter<double>("step_duration_s", 5.0);
+            settle_ms_ = this->declare_parameter<int64_t>("settle_ms", 200);
+            max_loss_ = this->declare_parameter<double>("max_loss", 0.01);
+            p99_limit_ms_ = this->declare_parameter<double>("p99_limit_ms", 10.0);
+            auto control_topic = this->declare_parameter<std::string>("control_topic", "/arm_standalone/control");
+            auto feedback_topic = this->declare_parameter<std::string>("feedback_topic", "joint_states");
+            for (std::size_t i = 0; i < helpers::num_joints; i++) {
+                command_.joints.push_back("Joint" + std::to_string(i + 1));
+            }
+            command_.goals.resize(helpers::num_joints);
+            publisher_ = this->create_publisher<JointControl>(control_topic, 10);
+            subscription_ = this->create_subscription<JointState>(
+                    feedback_topic, rclcpp::QoS(1000),
+                    [this](const JointState::SharedPtr msg){ on_feedback(*msg); });
+        }
+
+        /**
+         * Runs every configured rate on the given executor and prints one row per rate
+         * @return the results, in the order of the rates parameter
+         */
+        template<typename Executor>
+        std::vector<StepResult> run(Executor &executor){
+            std::vector<StepResult> results;
+            std::printf("%10s %8s %8s %8s %10s %9s %9s %9s %9s %9s\n", "rate_hz", "sent", "matched", "loss%",
+                        "fb_hz", "p50_ms", "p90_ms", "p99_ms", "p99.9_ms", "max_ms");
+            for (auto rate : rates_) {
+                if (!rclcpp::ok() || rate <= 0) {
+                    continue;
+                }
+                auto result = run_step(executor, static_cast<double>(rate));
+                std::printf("%10.0f %8zu %8zu %8.2f %10.1f %9.3f %9.3f %9.3f %9.3f %9.3f\n", result.rate_hz,
+                            result.sent, result.matched, result.loss() * 100,
+                            static_cast<double>(result.feedback) / result.duration_s,
+                            result.percentile_ms(50), result.percentile_ms(90), result.percentile_ms(99),
+                            result.percentile_ms(99.9), result.percentile_ms(100));
+                results.push_back(std::move(result));
+            }
+            return results;
+        }
+
+        /**
+         * @return the highest rate that met the loss and p99 limits, 0 if none did
+         */
+        double max_sustainable_rate(const std::vector<StepResult> &results) const {
+            double best = 0;
+            for (const auto &result : results) {
+                if (result.matched > 0 && result.loss() <= max_loss_ && result.percentile_ms(99) <= p99_limit_ms_) {
+                    best = std::max(best, result.rate_hz);
+                }
+            }
+            return best;
+        }
+
+        double max_loss() const { return max_loss_; }
+
+        double p99_limit_ms() const { return p99_limit_ms_; }
+
+    private:
+        template<typename Executor>
+        StepResult run_step(Executor &executor, double rate_hz){
+            step_ = StepResult{};
+            step_.rate_hz = rate_hz;
+            in_flight_.clear();
+            auto period = std::chrono::nanoseconds(static_cast<std::int64_t>(1e9 / rate_hz));
+            auto timer = this->create_wall_timer(period, [this](){ send_command(); });
+            auto start = steady_ns();
+            auto end = start + static_cast<std::int64_t>(step_duration_s_ * 1e9);
+            while (rclcpp::ok() && steady_ns() < end) {
+                executor.spin_once(std::chrono::milliseconds(10));
+            }
+            timer->cancel();
+            // late echoes still count, new commands are no longer sent
+            auto settle_end = steady_ns() + settle_ms_ * 1000000;
+            while (rclcpp::ok() && steady_ns() < settle_end) {
+                executor.spin_once(std::chrono::milliseconds(10));
+            }
+            step_.duration_s = static_cast<double>(steady_ns() - start) * 1e-9;
+            std::sort(step_.rtt_ns.begin(), step_.rtt_ns.end());
+            return std::move(step_);
+        }
+
+        void send_command(){
+            auto stamp = this->now();
+            command_.header.stamp = stamp;
+            // slow sine so the simulated joints keep moving
+            auto phase = static_cast<double>(stamp.nanoseconds()) * 1e-9;
+            for (std::size_t i = 0; i < command_.goals.size(); i++) {
+                command_.goals[i] = 0.5 * std::sin(phase + static_cast<double>(i));
+            }
+            in_flight_[stamp_ns(command_.header.stamp.sec, command_.header.stamp.nanosec)] = steady_ns();
+            publisher_->publish(command_);
+            step_.sent++;
+        }
+
+        void on_feedback(const JointState &msg){
+            auto received = steady_ns();
+            step_.feedback++;
+            auto command = in_flight_.find(stamp_ns(msg.header.stamp.sec, msg.header.stamp.nanosec));
+            if (command == in_flight_.end()) {
+                return;
+            }
+            step_.rtt_ns.push_back(received - command->second);
+            step_.matched++;
+            in_flight_.erase(command);
+        }
+
+        std::vector<int64_t> rates_;
+        double step_duration_s_;
+        int64_t settle_ms_;
+        double max_loss_;
+        double p99_limit_ms_;
+        JointControl command_;
+        rclcpp::Publisher<JointControl>::SharedPtr publisher_;
+        rclcpp::Subscription<JointState>::SharedPtr subscription_;
+        // command stamp -> steady clock time it was published
+        std::unordered_map<std::int64_t, std::int64_t> in_flight_;
+        StepResult step_;
+    };
+}
+
+int main(int argc, char *argv[]){
+    rclcpp::init(argc, argv);
+    auto harness = std::make_shared<LatencyHarness>();
+    rclcpp::executors::SingleThreadedExecutor executor;
+    executor.add_node(harness);
+    auto results = harness->run(executor);
+    auto best = harness->max_sustainable_rate(results);
+    if (best > 0) {
+        std::printf("max sustainable rate: %.0f Hz (loss <= %.1f%%, p99 <= %.1f ms)\n", best,
+                    harness->max_loss() * 100, harness->p99_limit_ms());
+    } else {
+        std::printf("no rate met the limits (loss <= %.1f%%, p99 <= %.1f ms)\n",
+                    harness->max_loss() * 100, harness->p99_limit_ms());
+    }
+    rclcpp::shutdown();
+    return best > 0 ? 0 : 1;
+}
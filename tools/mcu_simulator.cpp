@@ -0,0 +1,461 @@
+/*
+ * Simulated microcontroller on one end of a pty, for running the agent without hardware.
+ *
+ *   mcu_simulator --link /tmp/ttyMCU --rate 200 --error-rate 0.01
+ *   ros2 run ros2_uart_agent raspi_pub --ros-args -p device:=/tmp/ttyMCU
+ *
+ * It behaves like the firmware: command frames are parsed and validated, the joints slew towards
+ * the commanded goals, and ADC feedback frames are streamed back. The first feedback frame after a
+ * command echoes the command's timestamp, so the agent publishes it in the JointState header and
+ * round trip latency can be measured end to end (tools/latency_harness). The other frames are
+ * stamped on the commander's clock, extrapolated from the last command, so the stamps the agent
+ * sees never go backwards.
+ */
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cmath>
+#include <csignal>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <iostream>
+#include <optional>
+#include <random>
+#include <string>
+#include <thread>
+#include <fcntl.h>
+#include <termios.h>
+#include <time.h>
+#include <unistd.h>
+
+#include "ros2_uart_agent/adc_decoder.hpp"
+#include "ros2_uart_agent/ascii_encoder.hpp"
+#include "ros2_uart_agent/binary_protocol.hpp"
+#include "ros2_uart_agent/frame_parser.hpp"
+#include "ros2_uart_agent/serial_port.hpp"
+
+namespace{
+    std::atomic<bool> stop_requested{false};
+
+    void on_signal(int){
+        stop_requested.store(true);
+    }
+
+    struct Options{
+        std::string link;
+        helpers::Protocol protocol = helpers::Protocol::Ascii;
+        unsigned int baud = 1000000;
+        // paces writes to what the UART could carry at baud, 8N1
+        bool pace = true;
+        // periodic feedback rate in Hz, 0 to only answer commands
+        double rate_hz = 100;
+        // answer every command with a feedback frame right away instead of on the next tick
+        bool echo_immediate = true;
+        double error_rate = 0;
+        double drop_rate = 0;
+        std::size_t burst_size = 0;
+        int burst_period_ms = 1000;
+        double slew_rad_s = 6;
+        int stats_period_s = 5;
+        unsigned int seed = 1;
+    };
+
+    void print_usage(const char *name){
+        std::cout << "Usage: " << name << " [options]\n"
+                  << "  --link PATH           symlink PATH to the pty slave\n"
+                  << "  --protocol ascii|binary\n"
+                  << "  --baud N              line rate used for pacing (default 1000000)\n"
+                  << "  --no-pace             write as fast as the pty allows\n"
+                  << "  --rate HZ             periodic feedback rate, 0 to disable (default 100)\n"
+                  << "  --no-echo             only report command timestamps on the periodic feedback\n"
+                  << "  --error-rate P        probability of flipping a bit in an outgoing frame\n"
+                  << "  --drop-rate P         probability of dropping an outgoing frame\n"
+                  << "  --burst N             send N extra feedback frames back to back ...\n"
+                  << "  --burst-period MS     ... every MS milliseconds (default 1000)\n"
+                  << "  --slew RAD_S          joint speed towards the goal (default 6)\n"
+                  << "  --stats S             print statistics every S seconds, 0 to disable (default 5)\n"
+                  << "  --seed N              seed for fault injection\n";
+    }
+
+    std::optional<Options> parse_options(int argc, char *argv[]){
+        Options options;
+        for (int i = 1; i < argc; i++) {
+            std::string arg = argv[i];
+            auto next = [&]() -> const char * {
+                if (i + 1 >= argc) {
+                    std::cerr << "Missing value for " << arg << std::endl;
+                    return nullptr;
+                }
+                return argv[++i];
+            };
+            const char *value = nullptr;
+            if (arg == "--no-pace") {
+                options.pace = false;
+            } else if (arg == "--no-echo") {
+                options.echo_immediate = false;
+            } else if (arg == "--help" || arg == "-h") {
+                print_usage(argv[0]);
+                std::exit(0);
+            } else if ((value = next()) == nullptr) {
+                return std::nullopt;
+            } else if (arg == "--link") {
+                options.link = value;
+            } else if (arg == "--protocol") {
+                auto protocol = helpers::protocol_from_string(value);
+                if (!protocol) {
+                    std::cerr << "Unknown protocol " << value << std::endl;
+                    return std::nullopt;
+                }
+                options.protocol = *protocol;
+            } else if (arg == "--baud") {
+                options.baud = static_cast<unsigned int>(std::strtoul(value, nullptr, 10));
+            } else if (arg == "--rate") {
+                options.rate_hz = std::strtod(value, nullptr);
+            } else if (arg == "--error-rate") {
+                options.error_rate = std::strtod(value, nullptr);
+            } else if (arg == "--drop-rate") {
+                options.drop_rate = std::strtod(value, nullptr);
+            } else if (arg == "--burst") {
+                options.burst_size = std::strtoul(value, nullptr, 10);
+            } else if (arg == "--burst-period") {
+                options.burst_period_ms = std::atoi(value);
+            } else if (arg == "--slew") {
+                options.slew_rad_s = std::strtod(value, nullptr);
+            } else if (arg == "--stats") {
+                options.stats_period_s = std::atoi(value);
+            } else if (arg == "--seed") {
+                options.seed = static_cast<unsigned int>(std::strtoul(value, nullptr, 10));
+            } else {
+                std::cerr << "Unknown option " << arg << std::endl;
+                print_usage(argv[0]);
+                return std::nullopt;
+            }
+        }
+        return options;
+    }
+
+    std::int64_t steady_ns(){
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+
+    // before the first command feedback is stamped with the wall clock, like the ROS clock of the agent
+    std::int64_t realtime_ns(){
+        timespec now{};
+        clock_gettime(CLOCK_REALTIME, &now);
+        return static_cast<std::int64_t>(now.tv_sec) * 1000000000 + now.tv_nsec;
+    }
+
+    class McuSimulator{
+    public:
+        explicit McuSimulator(const Options &options)
+                : options_(options), rng_(options.seed) {
+            auto calibration = helpers::default_calibration<helpers::num_joints>();
+            for (std::size_t i = 0; i < helpers::num_joints; i++) {
+                calibration_[i] = calibration[i];
+            }
+        }
+
+        ~McuSimulator(){
+            if (slave_fd_ >= 0) {
+                ::close(slave_fd_);
+            }
+            if (!options_.link.empty()) {
+                ::unlink(options_.link.c_str());
+            }
+        }
+
+        bool open(){
+            int master_fd = posix_openpt(O_RDWR | O_NOCTTY | O_CLOEXEC);
+            if (master_fd < 0 || grantpt(master_fd) < 0 || unlockpt(master_fd) < 0) {
+                std::perror("posix_openpt");
+                return false;
+            }
+            std::string slave_path = ptsname(master_fd);
+            // Holding the slave open keeps the master from reporting a hangup while no agent is connected.
+            // The line discipline is made raw here as well, so nothing is echoed back before the agent
+            // configures the port itself.
+            slave_fd_ = ::open(slave_path.c_str(), O_RDWR | O_NOCTTY | O_CLOEXEC);
+            termios slave_options{};
+            if (slave_fd_ < 0 || tcgetattr(slave_fd_, &slave_options) < 0) {
+                std::perror(slave_path.c_str());
+                return false;
+            }
+            cfmakeraw(&slave_options);
+            tcsetattr(slave_fd_, TCSANOW, &slave_options);
+            if (!port_.attach(master_fd, options_.baud)) {
+                return false;
+            }
+            if (!options_.link.empty()) {
+                ::unlink(options_.link.c_str());
+                if (::symlink(slave_path.c_str(), options_.link.c_str()) < 0) {
+                    std::perror(options_.link.c_str());
+                    return false;
+                }
+            }
+            std::cout << "Simulated microcontroller on " << slave_path
+                      << (options_.link.empty() ? "" : " (" + options_.link + ")") << std::endl;
+            return true;
+        }
+
+        void run(){
+            std::array<char, 4096> chunk{};
+            auto now = steady_ns();
+            std::int64_t tick_period = options_.rate_hz > 0 ? static_cast<std::int64_t>(1e9 / options_.rate_hz) : 0;
+            std::int64_t next_tick = now + tick_period;
+            std::int64_t next_burst = now + options_.burst_period_ms * 1000000LL;
+            std::int64_t next_stats = now + options_.stats_period_s * 1000000000LL;
+            last_update_ns_ = now;
+            while (!stop_requested.load()) {
+                now = steady_ns();
+                auto deadline = INT64_MAX;
+                if (tick_period > 0) {
+                    deadline = next_tick;
+                }
+                if (options_.burst_size > 0) {
+                    deadline = std::min(deadline, next_burst);
+                }
+                if (options_.stats_period_s > 0) {
+                    deadline = std::min(deadline, next_stats);
+                }
+                int timeout_ms = deadline == INT64_MAX ? 100 : static_cast<int>(std::max<std::int64_t>(0, (deadline - now) / 1000000));
+                auto bytes_read = port_.read_some(chunk.data(), chunk.size(), std::min(timeout_ms, 100));
+                if (bytes_read < 0) {
+                    break;
+                }
+                if (bytes_read > 0) {
+                    feed(chunk.data(), static_cast<std::size_t>(bytes_read));
+                }
+                now = steady_ns();
+                if (tick_period > 0 && now >= next_tick) {
+                    send_feedback(1);
+                    // skip missed ticks rather than sending them all at once, bursts are explicit
+                    next_tick = std::max(next_tick + tick_period, now);
+                }
+                if (options_.burst_size > 0 && now >= next_burst) {
+                    send_feedback(options_.burst_size);
+                    next_burst = now + options_.burst_period_ms * 1000000LL;
+                }
+                if (options_.stats_period_s > 0 && now >= next_stats) {
+                    print_stats();
+                    next_stats = now + options_.stats_period_s * 1000000000LL;
+                }
+            }
+            print_stats();
+        }
+
+    private:
+        void feed(const char *data, std::size_t length){
+            if (options_.protocol == helpers::Protocol::Binary) {
+                binary_decoder_.feed(data, length, [this](const helpers::BinaryFrameView &frame){
+                    if (frame.type != helpers::BinaryMessageType::JointCommand) {
+                        return;
+                    }
+                    std::array<double, helpers::binary::max_values> goals{};
+                    for (std::size_t i = 0; i < frame.count; i++) {
+                        goals[i] = frame.goal(i);
+                    }
+                    on_command(goals.data(), frame.count, frame.sec, frame.nsec);
+                });
+            } else {
+                parser_.feed(data, length, [this](const helpers::FrameView &frame){
+                    std::array<double, helpers::ascii::max_goals> goals{};
+                    auto count = parse_ascii_goals(frame.payload, goals);
+                    on_command(goals.data(), count, frame.sec, frame.nsec);
+                });
+            }
+        }
+
+        static std::size_t parse_ascii_goals(std::string_view payload, std::array<double, helpers::ascii::max_goals> &goals){
+            std::array<char, helpers::ascii::max_payload_size + 1> text{};
+            auto length = std::min(payload.length(), text.size() - 1);
+            std::copy(payload.cbegin(), payload.cbegin() + length, text.data());
+            std::size_t count = 0;
+            char *cursor = text.data();
+            while (count < goals.size()) {
+                char *end = nullptr;
+                auto value = std::strtod(cursor, &end);
+                if (end == cursor) {
+                    break;
+                }
+                goals[count++] = value;
+                cursor = end;
+            }
+            return count;
+        }
+
+        void on_command(const double *goals, std::size_t count, std::uint32_t sec, std::uint32_t nsec){
+            commands_++;
+            advance_joints();
+            for (std::size_t i = 0; i < std::min(count, helpers::num_joints); i++) {
+                goals_[i] = goals[i];
+            }
+            echo_stamp_ns_ = static_cast<std::int64_t>(sec) * 1000000000 + nsec;
+            command_clock_offset_ns_ = *echo_stamp_ns_ - steady_ns();
+            if (options_.echo_immediate) {
+                send_feedback(1);
+            }
+        }
+
+        // moves the simulated joints towards their goals at the configured slew rate
+        void advance_joints(){
+            auto now = steady_ns();
+            auto max_step = options_.slew_rad_s * static_cast<double>(now - last_update_ns_) * 1e-9;
+            last_update_ns_ = now;
+            for (std::size_t i = 0; i < helpers::num_joints; i++) {
+                auto error = goals_[i] - positions_[i];
+                positions_[i] += std::clamp(error, -max_step, max_step);
+            }
+        }
+
+        // inverse of AdcCalibration
+        std::uint16_t to_adc(std::size_t joint) const {
+            const auto &calibration = calibration_[joint];
+            auto half_range = calibration.range_deg * M_PI / 360.0;
+            auto adc = (positions_[joint] / half_range * (calibration.adc_high - calibration.adc_low)
+                        + calibration.adc_high + calibration.adc_low) / 2.0;
+            return static_cast<std::uint16_t>(std::clamp(std::lround(adc), 0L, 4095L));
+        }
+
+        std::size_t encode_feedback(char *buffer){
+            std::array<std::uint16_t, helpers::num_joints> adc_values{};
+            for (std::size_t i = 0; i < helpers::num_joints; i++) {
+                adc_values[i] = to_adc(i);
+            }
+            auto stamp_ns = next_stamp_ns();
+            auto sec = static_cast<std::uint32_t>(stamp_ns / 1000000000);
+            auto nsec = static_cast<std::uint32_t>(stamp_ns % 1000000000);
+            if (options_.protocol == helpers::Protocol::Binary) {
+                return helpers::encode_binary_feedback(buffer, adc_values.data(), adc_values.size(), sec, nsec);
+            }
+            std::array<char, helpers::num_joints * 5> payload{};
+            char *out = payload.data();
+            for (auto value : adc_values) {
+                out = helpers::write_decimal(out, value, 4);
+                *out++ = '\t';
+            }
+            *(out - 1) = '\n';
+            return helpers::frame_ascii_payload(buffer, std::string_view(payload.data(), payload.size()),
+                                                sec, nsec);
+        }
+
+        // Stamps must strictly increase, the agent's velocity estimator resets whenever dt <= 0. An
+        // echo older than the last stamp sent (the command was overtaken by a periodic frame) is
+        // not sent, and a periodic stamp never advances less than the time since the last frame.
+        std::int64_t next_stamp_ns(){
+            auto now = steady_ns();
+            std::int64_t stamp_ns;
+            if (echo_stamp_ns_ && *echo_stamp_ns_ > last_stamp_ns_) {
+                stamp_ns = *echo_stamp_ns_;
+            } else {
+                stamp_ns = command_clock_offset_ns_ ? now + *command_clock_offset_ns_ : realtime_ns();
+                if (last_stamp_ns_ > 0) {
+                    stamp_ns = std::max(stamp_ns, last_stamp_ns_ + std::max<std::int64_t>(now - last_stamp_steady_ns_, 1));
+                }
+            }
+            echo_stamp_ns_.reset();
+            last_stamp_ns_ = stamp_ns;
+            last_stamp_steady_ns_ = now;
+            return stamp_ns;
+        }
+
+        void send_feedback(std::size_t frames){
+            advance_joints();
+            std::size_t length = 0;
+            for (std::size_t i = 0; i < frames && length + frame_capacity <= tx_buffer_.size(); i++) {
+                auto frame = tx_buffer_.data() + length;
+                auto frame_length = encode_feedback(frame);
+                if (chance(options_.drop_rate)) {
+                    dropped_++;
+                    continue;
+                }
+                if (chance(options_.error_rate)) {
+                    std::uniform_int_distribution<std::size_t> byte(0, frame_length - 1);
+                    std::uniform_int_distribution<int> bit(0, 7);
+                    frame[byte(rng_)] ^= static_cast<char>(1 << bit(rng_));
+                    corrupted_++;
+                }
+                length += frame_length;
+                sent_++;
+            }
+            if (length == 0) {
+                return;
+            }
+            pace(length);
+            if (port_.write_all(tx_buffer_.data(), length) < 0) {
+                write_errors_++;
+            }
+        }
+
+        // blocks until the simulated line has had time to shift out the previous frames
+        void pace(std::size_t length){
+            if (!options_.pace || options_.baud == 0) {
+                return;
+            }
+            auto now = steady_ns();
+            if (line_free_ns_ > now) {
+                std::this_thread::sleep_for(std::chrono::nanoseconds(line_free_ns_ - now));
+                now = line_free_ns_;
+            }
+            // 10 bits per byte with 8N1
+            line_free_ns_ = now + static_cast<std::int64_t>(length) * 10 * 1000000000LL / options_.baud;
+        }
+
+        bool chance(double probability){
+            return probability > 0 && std::uniform_real_distribution<double>(0, 1)(rng_) < probability;
+        }
+
+        void print_stats() const {
+            std::uint64_t rx_errors = options_.protocol == helpers::Protocol::Binary
+                                      ? binary_decoder_.total_error_count() : parser_.total_error_count();
+            std::cout << "commands " << commands_ << ", rx errors " << rx_errors
+                      << ", feedback sent " << sent_ << ", dropped " << dropped_
+                      << ", corrupted " << corrupted_ << ", write errors " << write_errors_ << std::endl;
+        }
+
+        static constexpr std::size_t frame_capacity = std::max(helpers::ascii::max_frame_size, helpers::binary::max_encoded_size);
+
+        Options options_;
+        helpers::SerialPort port_;
+        int slave_fd_ = -1;
+        helpers::FrameParser parser_;
+        helpers::BinaryFrameDecoder binary_decoder_;
+        std::mt19937 rng_;
+        std::array<helpers::JointCalibration, helpers::num_joints> calibration_{};
+        std::array<double, helpers::num_joints> goals_{};
+        std::array<double, helpers::num_joints> positions_{};
+        std::int64_t last_update_ns_ = 0;
+        std::int64_t line_free_ns_ = 0;
+        // stamp of the last command, until it has been echoed
+        std::optional<std::int64_t> echo_stamp_ns_;
+        // commander's clock - steady clock, measured when the last command arrived
+        std::optional<std::int64_t> command_clock_offset_ns_;
+        std::int64_t last_stamp_ns_ = 0;
+        std::int64_t last_stamp_steady_ns_ = 0;
+        std::array<char, frame_capacity * 64> tx_buffer_{};
+        std::uint64_t commands_ = 0;
+        std::uint64_t sent_ = 0;
+        std::uint64_t dropped_ = 0;
+        std::uint64_t corrupted_ = 0;
+        std::uint64_t write_errors_ = 0;
+    };
+}
+
+int main(int argc, char *argv[]){
+    auto options = parse_options(argc, argv);
+    if (!options) {
+        return 1;
+    }
+    std::signal(SIGINT, on_signal);
+    std::signal(SIGTERM, on_signal);
+    McuSimulator simulator(*options);
+    if (!simulator.open()) {
+        return 1;
+    }
+    simulator.run();
+    return 0;
+}